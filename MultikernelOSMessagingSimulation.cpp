@@ -6,6 +6,8 @@
 
 #include <iostream>
 #include <vector>
+#include <deque>
+#include <functional>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -55,6 +57,7 @@ struct PerfCounters {
     std::atomic<uint64_t> messages_sent{0};
     std::atomic<uint64_t> messages_received{0};
     std::atomic<uint64_t> total_latency_ns{0};
+    std::atomic<uint64_t> messages_deferred{0};
 };
 
 // Forward declaration
@@ -115,6 +118,23 @@ public:
         return msg;
     }
 
+    // Pops a message, waiting at most `timeout`. False if none arrived in
+    // time or the core is stopping, so a caller can interleave other work.
+    bool pop_for(Message& out, bool& running_flag, std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(mtx);
+
+        if (!cv.wait_for(lock, timeout, [&] { return head != tail || !running_flag; })) {
+            return false;
+        }
+        if (head == tail) {
+            return false;
+        }
+
+        out = buffer[head];
+        head = (head + 1) % QUEUE_SIZE;
+        return true;
+    }
+
     // Force wake up for shutdown
     void wake_all() {
         std::lock_guard<std::mutex> lock(mtx);
@@ -126,6 +146,7 @@ class Core {
 public:
     int id;
     MessageQueue inbox;
+    std::deque<Message> deferred; // Set aside by selective receive, owned by the core thread
     PerfCounters stats;
     int current_leader = -1;
     bool running = true;
@@ -163,18 +184,74 @@ public:
 
     // --- API: Receive Message ---
     Message receive_message() {
+        // Messages set aside by a selective receive come back first, in arrival order
+        if (!deferred.empty()) {
+            Message msg = deferred.front();
+            deferred.pop_front();
+            return msg;
+        }
+        return pop_counted();
+    }
+
+    // Like receive_message(), but gives up after `timeout`. Waiting on more
+    // than one queue at once is the WaitSet in the main tree, not this demo.
+    bool receive_message_for(Message& msg, std::chrono::milliseconds timeout) {
+        if (!deferred.empty()) {
+            msg = deferred.front();
+            deferred.pop_front();
+            return true;
+        }
+        if (!inbox.pop_for(msg, running, timeout)) {
+            return false;
+        }
+        count_received(msg);
+        return true;
+    }
+
+    // --- API: Selective Receive ---
+    // Waits for a message matching `match`. Anything else is deferred and
+    // handed out later by receive_message(), so a protocol step can run
+    // while ordinary traffic keeps arriving. SHUTDOWN always matches.
+    Message receive_matching(const std::function<bool(const Message&)>& match) {
+        for (auto it = deferred.begin(); it != deferred.end(); ++it) {
+            if (match(*it)) {
+                Message msg = *it;
+                deferred.erase(it);
+                return msg;
+            }
+        }
+
+        while (true) {
+            Message msg = pop_counted();
+            if (msg.type == MsgType::SHUTDOWN || match(msg)) return msg;
+
+            deferred.push_back(msg);
+            stats.messages_deferred++;
+        }
+    }
+
+    Message receive_message(MsgType type) {
+        return receive_matching([type](const Message& msg) { return msg.type == type; });
+    }
+
+    // Takes the next message off the ring and accounts for it
+    Message pop_counted() {
         Message msg = inbox.pop(running);
 
         if (msg.type != MsgType::SHUTDOWN) {
-            stats.messages_received++;
-            uint64_t now = get_time_ns();
-            if (now > msg.timestamp) {
-                stats.total_latency_ns += (now - msg.timestamp);
-            }
+            count_received(msg);
         }
         return msg;
     }
 
+    void count_received(const Message& msg) {
+        stats.messages_received++;
+        uint64_t now = get_time_ns();
+        if (now > msg.timestamp) {
+            stats.total_latency_ns += (now - msg.timestamp);
+        }
+    }
+
     // --- Algorithm: Distributed Barrier ---
     void enter_barrier() {
         // Use a localized string stream for thread-safe printing
@@ -187,10 +264,9 @@ public:
             // Coordinator Logic
             int cores_arrived = 1; // Count self
             while (cores_arrived < NUM_CORES) {
-                Message msg = receive_message();
-                if (msg.type == MsgType::BARRIER_REACHED) {
-                    cores_arrived++;
-                }
+                Message msg = receive_message(MsgType::BARRIER_REACHED);
+                if (msg.type == MsgType::SHUTDOWN) return;
+                cores_arrived++;
             }
             
             {
@@ -203,12 +279,12 @@ public:
                 send_message(i, MsgType::BARRIER_GO, "GO");
             }
         } else {
-            // Worker Logic
+            // Worker Logic: the PING is ordinary traffic that overlaps the
+            // barrier; the coordinator defers it rather than dropping it
+            send_message(0, MsgType::PING, "hello");
             send_message(0, MsgType::BARRIER_REACHED);
-            while (true) {
-                Message msg = receive_message();
-                if (msg.type == MsgType::BARRIER_GO) break;
-            }
+            Message msg = receive_message(MsgType::BARRIER_GO);
+            if (msg.type == MsgType::SHUTDOWN) return;
         }
         
         {
@@ -259,12 +335,21 @@ public:
 
         // 3. Message Processing Loop
         while (running) {
-            Message msg = receive_message();
+            // Bounded wait, so a stop is noticed even without a wakeup
+            Message msg;
+            if (!receive_message_for(msg, std::chrono::milliseconds(100))) continue;
             
             switch (msg.type) {
                 case MsgType::SHUTDOWN:
                     running = false;
                     break;
+                case MsgType::PING:
+                    {
+                        std::lock_guard<std::mutex> cout_lock(print_mutex);
+                        std::cout << "[Core " << id << "] PING from Core " << msg.src_core_id
+                                  << ": " << msg.payload << std::endl;
+                    }
+                    break;
                 case MsgType::ELECTION_WINNER:
                     current_leader = msg.src_core_id;
                     {
@@ -340,6 +425,7 @@ int main() {
                   << ": Avg Latency: " << avg_lat << " us"
                   << " | Sent: " << system_cores[i]->stats.messages_sent
                   << " | Recv: " << system_cores[i]->stats.messages_received 
+                  << " | Deferred: " << system_cores[i]->stats.messages_deferred
                   << std::endl;
         
         delete system_cores[i];
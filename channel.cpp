@@ -0,0 +1,272 @@
+#include "multikernel.h"
+#include <algorithm>
+#include <memory>
+#include <cstddef>
+
+// ============================================================================
+// CHANNEL MEMORY BUDGET
+// ============================================================================
+
+static std::atomic<uint64_t> memory_budget{CHANNEL_MEMORY_BUDGET};
+static std::atomic<uint64_t> memory_in_use{0};
+
+void set_channel_memory_budget(uint64_t bytes) {
+    memory_budget.store(bytes);
+}
+
+uint64_t channel_memory_budget() {
+    return memory_budget.load();
+}
+
+uint64_t channel_memory_in_use() {
+    return memory_in_use.load();
+}
+
+static bool reserve_memory(uint64_t bytes) {
+    uint64_t current = memory_in_use.load();
+    do {
+        if (current + bytes > memory_budget.load()) return false;
+    } while (!memory_in_use.compare_exchange_weak(current, current + bytes));
+    return true;
+}
+
+// ============================================================================
+// CHANNEL IMPLEMENTATION
+// ============================================================================
+
+Channel::Channel(int source, int dest, std::shared_ptr<HugePageArena> ring_arena,
+                 size_t ring_capacity)
+    : source_core(source), dest_core(dest), arena(std::move(ring_arena)),
+      slot_count(channel_slots(ring_capacity)),
+      ring(static_cast<uint8_t*>(arena->allocate(slot_count * CHANNEL_SLOT_SIZE))),
+      last_used_ms(steady_now_ms()) {
+    // Opening a link never fails on the budget; only growth is gated
+    memory_in_use += memory_bytes();
+}
+
+Channel::~Channel() {
+    arena->deallocate(ring, memory_bytes());
+    memory_in_use -= memory_bytes();
+}
+
+template <typename T>
+static void put_field(uint8_t* record, size_t offset, const T& value) {
+    memcpy(record + offset, &value, sizeof(T));
+}
+
+bool Channel::write_record(const Message& msg, const PeerMeta& meta) {
+    size_t payload = msg.payload_size();
+    size_t needed = slots_for(MESSAGE_HEADER_SIZE + payload);
+
+    // An empty ring rewinds, so a lone message never needs padding
+    if (used == 0) {
+        head = 0;
+    }
+
+    size_t tail = head + used;
+    if (tail >= slot_count) tail -= slot_count;
+    size_t at = tail;
+    size_t pad = 0;
+    if (tail + needed > slot_count) {
+        // Keep the message contiguous: skip to the start of the ring
+        pad = slot_count - tail;
+        at = 0;
+    }
+    if (used + pad + needed > slot_count) {
+        return false;
+    }
+
+    if (pad > 0) {
+        pad_at = tail;
+        pad_slots = pad;
+    }
+
+    // Header, then only the payload bytes in use. The stored length is
+    // always explicit, whatever form the sender used.
+    uint8_t* record = ring + at * CHANNEL_SLOT_SIZE;
+    memcpy(record, &msg, MESSAGE_HEADER_SIZE);
+    put_field(record, offsetof(Message, data_len), static_cast<uint16_t>(payload));
+    put_field(record, offsetof(Message, sender_load), meta.load);
+    put_field(record, offsetof(Message, sender_epoch), meta.epoch);
+    memcpy(record + MESSAGE_HEADER_SIZE, msg.data, payload);
+
+    used += pad + needed;
+    count++;
+    peak_used = std::max(peak_used, used);
+    bytes_written.fetch_add(MESSAGE_HEADER_SIZE + payload, std::memory_order_relaxed);
+    return true;
+}
+
+void Channel::skip_padding() {
+    if (head == pad_at) {
+        head = 0;
+        used -= pad_slots;
+        pad_at = SIZE_MAX;
+        pad_slots = 0;
+    }
+}
+
+bool Channel::push(const Message& msg, const PeerMeta& meta) {
+    std::lock_guard<std::mutex> lock(channel_mutex);
+
+    if (closed) {
+        return false;
+    }
+    if (!write_record(msg, meta)) {
+        refusals++;
+        return false;
+    }
+
+    last_used_ms.store(steady_now_ms(), std::memory_order_relaxed);
+    return true;
+}
+
+size_t Channel::push_batch(const Message* msgs, size_t n, const PeerMeta& meta) {
+    std::lock_guard<std::mutex> lock(channel_mutex);
+
+    if (closed) {
+        return 0;
+    }
+
+    size_t fit = 0;
+    while (fit < n && write_record(msgs[fit], meta)) {
+        fit++;
+    }
+    if (fit < n) {
+        refusals++;
+    }
+    if (fit > 0) {
+        last_used_ms.store(steady_now_ms(), std::memory_order_relaxed);
+    }
+    return fit;
+}
+
+bool Channel::pop(Message& msg) {
+    std::lock_guard<std::mutex> lock(channel_mutex);
+
+    if (count == 0) {
+        return false;
+    }
+
+    const uint8_t* record = ring + head * CHANNEL_SLOT_SIZE;
+    memcpy(static_cast<void*>(&msg), record, MESSAGE_HEADER_SIZE);
+    memcpy(msg.data, record + MESSAGE_HEADER_SIZE, msg.data_len);
+    if (msg.data_len < MAX_MESSAGE_SIZE) {
+        msg.data[msg.data_len] = '\0';
+    }
+
+    size_t slots = slots_for(MESSAGE_HEADER_SIZE + msg.data_len);
+    head += slots;
+    if (head >= slot_count) head -= slot_count;
+    used -= slots;
+    count--;
+    skip_padding();
+    trough_used = std::min(trough_used, used);
+    return true;
+}
+
+bool Channel::peek_deliver_at(std::chrono::steady_clock::time_point& when) {
+    std::lock_guard<std::mutex> lock(channel_mutex);
+
+    if (count == 0) {
+        return false;
+    }
+
+    memcpy(&when, ring + head * CHANNEL_SLOT_SIZE + offsetof(Message, deliver_at), sizeof(when));
+    return true;
+}
+
+bool Channel::peek_size(size_t& bytes) {
+    std::lock_guard<std::mutex> lock(channel_mutex);
+
+    if (count == 0) {
+        return false;
+    }
+
+    uint16_t payload;
+    memcpy(&payload, ring + head * CHANNEL_SLOT_SIZE + offsetof(Message, data_len), sizeof(payload));
+    bytes = MESSAGE_HEADER_SIZE + payload;
+    return true;
+}
+
+void Channel::sample_pressure(uint64_t& refused, size_t& peak_slots, size_t& trough_slots) {
+    std::lock_guard<std::mutex> lock(channel_mutex);
+    refused = refusals;
+    peak_slots = peak_used;
+    trough_slots = trough_used;
+    refusals = 0;
+    peak_used = used;
+    trough_used = used;
+}
+
+bool Channel::resize(size_t new_slot_count) {
+    size_t new_bytes = new_slot_count * CHANNEL_SLOT_SIZE;
+    if (new_bytes > memory_bytes() && !reserve_memory(new_bytes - memory_bytes())) {
+        return false;
+    }
+    uint8_t* fresh = static_cast<uint8_t*>(arena->allocate(new_bytes));
+
+    std::lock_guard<std::mutex> lock(channel_mutex);
+
+    // Walk the queued records oldest first and pack them from slot 0
+    size_t at = 0;
+    size_t from = head;
+    bool fits = true;
+    for (size_t i = 0; i < count; i++) {
+        if (from == pad_at) from = 0;
+        const uint8_t* record = ring + from * CHANNEL_SLOT_SIZE;
+
+        uint16_t payload;
+        memcpy(&payload, record + offsetof(Message, data_len), sizeof(payload));
+        size_t slots = slots_for(MESSAGE_HEADER_SIZE + payload);
+        if (at + slots > new_slot_count) {
+            fits = false;
+            break;
+        }
+
+        memcpy(fresh + at * CHANNEL_SLOT_SIZE, record, MESSAGE_HEADER_SIZE + payload);
+        at += slots;
+        from += slots;
+        if (from >= slot_count) from -= slot_count;
+    }
+
+    if (!fits) {
+        arena->deallocate(fresh, new_bytes);
+        if (new_bytes > memory_bytes()) memory_in_use -= new_bytes - memory_bytes();
+        return false;
+    }
+
+    arena->deallocate(ring, memory_bytes());
+    if (new_bytes < memory_bytes()) memory_in_use -= memory_bytes() - new_bytes;
+
+    ring = fresh;
+    slot_count = new_slot_count;
+    head = 0;
+    used = at;
+    pad_at = SIZE_MAX;
+    pad_slots = 0;
+    peak_used = used;
+    trough_used = used;
+    return true;
+}
+
+bool Channel::try_close() {
+    std::lock_guard<std::mutex> lock(channel_mutex);
+
+    // A sender may have pushed since the idle check; keep the link in that case
+    if (count > 0) {
+        return false;
+    }
+
+    closed = true;
+    return true;
+}
+
+bool Channel::is_closed() {
+    std::lock_guard<std::mutex> lock(channel_mutex);
+    return closed;
+}
+
+bool Channel::is_idle(int64_t now_ms, int64_t idle_ms) const {
+    return now_ms - last_used_ms.load(std::memory_order_relaxed) >= idle_ms;
+}
@@ -0,0 +1,83 @@
+#include "multikernel.h"
+#include <iostream>
+#include <cstdlib>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std::chrono_literals;
+
+// ============================================================================
+// CLUSTER DEMONSTRATION - Several nodes as local processes
+// ============================================================================
+
+const int PROBES_PER_NODE = 200;
+
+int run_node(int node_id, int num_nodes) {
+    ClusterNode node(node_id, num_nodes);
+    node.start();
+
+    if (!node.wait_for_peers(5000)) {
+        std::cerr << "[NODE " << node_id << "] Timed out waiting for peers" << std::endl;
+        node.stop();
+        return 1;
+    }
+
+    // Probe every node, ourselves included, so local and cross-node
+    // delivery are measured under the same traffic
+    for (int i = 0; i < PROBES_PER_NODE; i++) {
+        for (int dest = 0; dest < num_nodes; dest++) {
+            Message msg;
+            msg.type = MSG_HEARTBEAT;
+            snprintf(msg.data, MAX_MESSAGE_SIZE, "probe %d from node %d", i, node_id);
+            node.send({node_id, i % NUM_CORES}, {dest, (i + 1) % NUM_CORES}, msg);
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    node.flush();
+
+    // Give the other nodes time to finish sending to us
+    std::this_thread::sleep_for(1s);
+
+    node.print_latency_report();
+    node.stop();
+    return 0;
+}
+
+// ============================================================================
+// MAIN PROGRAM
+// ============================================================================
+//   multikernel_cluster [num_nodes]            fork every node locally
+//   multikernel_cluster <node_id> <num_nodes>  run a single node
+
+int main(int argc, char* argv[]) {
+    if (argc == 3) {
+        return run_node(std::atoi(argv[1]), std::atoi(argv[2]));
+    }
+
+    int num_nodes = argc == 2 ? std::atoi(argv[1]) : 2;
+    if (num_nodes < 1) {
+        std::cerr << "Usage: " << argv[0] << " [num_nodes] | <node_id> <num_nodes>" << std::endl;
+        return 1;
+    }
+
+    std::cout << "=== Multikernel Cluster: " << num_nodes << " nodes ===" << std::endl;
+    std::cout.flush();
+
+    std::vector<pid_t> children;
+    for (int i = 0; i < num_nodes; i++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            _exit(run_node(i, num_nodes));
+        }
+        children.push_back(pid);
+    }
+
+    int failures = 0;
+    for (pid_t child : children) {
+        int status = 0;
+        waitpid(child, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) failures++;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,453 @@
+#include "multikernel.h"
+#include <algorithm>
+#include <iomanip>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+
+// ============================================================================
+// FRAME ENCODING - Versioned, big-endian, batched
+// ============================================================================
+
+static const size_t FRAME_HEADER_SIZE = 12;
+static const size_t RECORD_FIXED_SIZE = 43;
+
+static void put_u16(std::vector<uint8_t>& out, uint16_t v) {
+    out.push_back(static_cast<uint8_t>(v >> 8));
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+static void put_u32(std::vector<uint8_t>& out, uint32_t v) {
+    put_u16(out, static_cast<uint16_t>(v >> 16));
+    put_u16(out, static_cast<uint16_t>(v));
+}
+
+static void put_u64(std::vector<uint8_t>& out, uint64_t v) {
+    put_u32(out, static_cast<uint32_t>(v >> 32));
+    put_u32(out, static_cast<uint32_t>(v));
+}
+
+static uint16_t get_u16(const uint8_t* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+static uint32_t get_u32(const uint8_t* p) {
+    return (static_cast<uint32_t>(get_u16(p)) << 16) | get_u16(p + 2);
+}
+
+static uint64_t get_u64(const uint8_t* p) {
+    return (static_cast<uint64_t>(get_u32(p)) << 32) | get_u32(p + 4);
+}
+
+static int64_t to_wire_time(std::chrono::steady_clock::time_point t) {
+    // steady_clock is CLOCK_MONOTONIC, which all local processes share
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+std::vector<uint8_t> encode_cluster_frame(const std::vector<ClusterEnvelope>& batch) {
+    std::vector<uint8_t> frame;
+    frame.reserve(FRAME_HEADER_SIZE + batch.size() * (RECORD_FIXED_SIZE + 32));
+
+    put_u32(frame, CLUSTER_FRAME_MAGIC);
+    put_u16(frame, CLUSTER_FRAME_VERSION);
+    put_u16(frame, static_cast<uint16_t>(batch.size()));
+    put_u32(frame, 0);  // Body length, patched below
+
+    for (const auto& e : batch) {
+        uint16_t data_len = static_cast<uint16_t>(e.msg.payload_size());
+
+        put_u16(frame, static_cast<uint16_t>(e.source.node));
+        put_u16(frame, static_cast<uint16_t>(e.dest.node));
+        put_u32(frame, static_cast<uint32_t>(e.source.core));
+        put_u32(frame, static_cast<uint32_t>(e.dest.core));
+        put_u32(frame, static_cast<uint32_t>(e.msg.type));
+        put_u32(frame, static_cast<uint32_t>(e.msg.process_id));
+        put_u32(frame, static_cast<uint32_t>(e.msg.topic));
+        put_u64(frame, static_cast<uint64_t>(to_wire_time(e.msg.timestamp)));
+        put_u64(frame, e.msg.has_deadline()
+                       ? static_cast<uint64_t>(to_wire_time(e.msg.expires_at)) : 0);
+        frame.push_back(e.msg.urgent ? 1 : 0);
+        put_u16(frame, data_len);
+        frame.insert(frame.end(), e.msg.data, e.msg.data + data_len);
+    }
+
+    uint32_t body_len = static_cast<uint32_t>(frame.size() - FRAME_HEADER_SIZE);
+    for (int i = 0; i < 4; i++) {
+        frame[8 + i] = static_cast<uint8_t>(body_len >> (24 - 8 * i));
+    }
+    return frame;
+}
+
+bool decode_cluster_frame_header(const uint8_t* header, uint16_t& count, uint32_t& body_len) {
+    if (get_u32(header) != CLUSTER_FRAME_MAGIC) return false;
+    if (get_u16(header + 4) != CLUSTER_FRAME_VERSION) return false;
+
+    count = get_u16(header + 6);
+    body_len = get_u32(header + 8);
+    return true;
+}
+
+bool decode_cluster_frame_body(const uint8_t* body, uint32_t body_len, uint16_t count,
+                               std::vector<ClusterEnvelope>& out) {
+    size_t offset = 0;
+
+    for (uint16_t i = 0; i < count; i++) {
+        if (offset + RECORD_FIXED_SIZE > body_len) return false;
+        const uint8_t* p = body + offset;
+
+        ClusterEnvelope e;
+        e.source.node = get_u16(p);
+        e.dest.node = get_u16(p + 2);
+        e.source.core = static_cast<int32_t>(get_u32(p + 4));
+        e.dest.core = static_cast<int32_t>(get_u32(p + 8));
+        e.msg.type = static_cast<MessageType>(get_u32(p + 12));
+        e.msg.process_id = static_cast<int32_t>(get_u32(p + 16));
+        e.msg.topic = static_cast<int32_t>(get_u32(p + 20));
+        e.msg.timestamp = std::chrono::steady_clock::time_point(
+            std::chrono::nanoseconds(static_cast<int64_t>(get_u64(p + 24))));
+        uint64_t expires = get_u64(p + 32);
+        if (expires != 0) {
+            e.msg.expires_at = std::chrono::steady_clock::time_point(
+                std::chrono::nanoseconds(static_cast<int64_t>(expires)));
+        }
+        e.msg.urgent = p[40] != 0;
+        uint16_t data_len = get_u16(p + 41);
+
+        offset += RECORD_FIXED_SIZE;
+        if (data_len > MAX_MESSAGE_SIZE || offset + data_len > body_len) return false;
+        memcpy(e.msg.data, body + offset, data_len);
+        e.msg.data_len = data_len;
+        if (data_len < MAX_MESSAGE_SIZE) e.msg.data[data_len] = '\0';
+        offset += data_len;
+
+        e.msg.source_core = e.source.core;
+        e.msg.dest_core = e.dest.core;
+        out.push_back(e);
+    }
+
+    return offset == body_len;
+}
+
+// ============================================================================
+// SOCKET HELPERS
+// ============================================================================
+
+static bool write_all(int fd, const uint8_t* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = ::send(fd, data, len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Appends what a non-blocking socket has ready; false once the peer is gone
+static bool read_available(int fd, std::vector<uint8_t>& buffer) {
+    uint8_t chunk[16384];
+    while (true) {
+        ssize_t n = ::read(fd, chunk, sizeof(chunk));
+        if (n > 0) {
+            buffer.insert(buffer.end(), chunk, chunk + n);
+            if (static_cast<size_t>(n) < sizeof(chunk)) return true;
+            continue;
+        }
+        if (n == 0) return false;
+        if (errno == EINTR) continue;
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+}
+
+// ============================================================================
+// CLUSTER NODE IMPLEMENTATION
+// ============================================================================
+
+ClusterNode::ClusterNode(int id, int nodes, const std::string& dir)
+    : node_id(id), num_nodes(nodes), socket_dir(dir) {
+    for (int i = 0; i < num_nodes; i++) {
+        peers.push_back(std::make_unique<ClusterPeer>());
+    }
+}
+
+ClusterNode::~ClusterNode() {
+    stop();
+}
+
+std::string ClusterNode::socket_path(int node) const {
+    return socket_dir + "/multikernel-node-" + std::to_string(node) + ".sock";
+}
+
+void ClusterNode::start() {
+    if (running) return;
+
+    // Listen for frames from the other nodes
+    std::string path = socket_path(node_id);
+    ::unlink(path.c_str());
+
+    listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    if (listen_fd < 0 ||
+        ::bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(listen_fd, num_nodes) < 0) {
+        std::cerr << "[NODE " << node_id << "] Cannot listen on " << path << std::endl;
+        if (listen_fd >= 0) ::close(listen_fd);
+        listen_fd = -1;
+        return;
+    }
+
+    system.start();
+
+    running = true;
+    receiver_thread = std::thread(&ClusterNode::receiver_loop, this);
+    flusher_thread = std::thread(&ClusterNode::flusher_loop, this);
+
+    std::cout << "[NODE " << node_id << "] Listening on " << path << std::endl;
+}
+
+void ClusterNode::stop() {
+    if (!running) return;
+
+    flush();
+    running = false;
+
+    if (receiver_thread.joinable()) receiver_thread.join();
+    if (flusher_thread.joinable()) flusher_thread.join();
+
+    for (auto& peer : peers) {
+        if (peer->fd >= 0) ::close(peer->fd);
+        peer->fd = -1;
+    }
+    if (listen_fd >= 0) ::close(listen_fd);
+    listen_fd = -1;
+    ::unlink(socket_path(node_id).c_str());
+
+    system.shutdown();
+}
+
+bool ClusterNode::connect_peer(int node) {
+    // Caller holds the peer's mutex
+    ClusterPeer& peer = *peers[node];
+    if (peer.fd >= 0) return true;
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socket_path(node).c_str(), sizeof(addr.sun_path) - 1);
+
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        ::close(fd);
+        return false;
+    }
+
+    peer.fd = fd;
+    return true;
+}
+
+bool ClusterNode::wait_for_peers(int timeout_ms) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+
+    for (int node = 0; node < num_nodes; node++) {
+        if (node == node_id) continue;
+
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(peers[node]->peer_mutex);
+                if (connect_peer(node)) break;
+            }
+            if (std::chrono::steady_clock::now() >= deadline) return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// SENDING - Local fast path, batched frames for other nodes
+// ============================================================================
+
+bool ClusterNode::send(GlobalCoreId source, GlobalCoreId dest, const Message& msg) {
+    if (dest.node < 0 || dest.node >= num_nodes ||
+        dest.core < 0 || dest.core >= NUM_CORES) {
+        std::cerr << "[NODE " << node_id << "] Invalid destination ("
+                  << dest.node << ", " << dest.core << ")" << std::endl;
+        return false;
+    }
+
+    ClusterEnvelope envelope;
+    envelope.source = source;
+    envelope.dest = dest;
+    envelope.msg = msg;
+    envelope.msg.timestamp = std::chrono::steady_clock::now();
+    envelope.msg.source_core = source.core;
+    envelope.msg.dest_core = dest.core;
+
+    if (dest.node == node_id) {
+        deliver(envelope);
+        return true;
+    }
+
+    bool full = false;
+    {
+        std::lock_guard<std::mutex> lock(peers[dest.node]->peer_mutex);
+        peers[dest.node]->pending.push_back(envelope);
+        full = peers[dest.node]->pending.size() >= CLUSTER_BATCH;
+    }
+
+    // A full batch goes out now; partial ones wait for the flusher
+    return full ? flush_peer(dest.node) : true;
+}
+
+bool ClusterNode::flush_peer(int node) {
+    std::lock_guard<std::mutex> lock(peers[node]->peer_mutex);
+    ClusterPeer& peer = *peers[node];
+
+    if (peer.pending.empty()) return true;
+    if (!connect_peer(node)) return false;  // Keep the batch for a later retry
+
+    // Frames never exceed CLUSTER_BATCH records, even after a backlog
+    while (!peer.pending.empty()) {
+        size_t n = std::min<size_t>(peer.pending.size(), CLUSTER_BATCH);
+        std::vector<ClusterEnvelope> batch(peer.pending.begin(), peer.pending.begin() + n);
+        std::vector<uint8_t> frame = encode_cluster_frame(batch);
+
+        if (!write_all(peer.fd, frame.data(), frame.size())) {
+            std::cerr << "[NODE " << node_id << "] Lost connection to node " << node << std::endl;
+            ::close(peer.fd);
+            peer.fd = -1;
+            return false;
+        }
+
+        peer.pending.erase(peer.pending.begin(), peer.pending.begin() + n);
+        frames_sent++;
+    }
+    return true;
+}
+
+void ClusterNode::flush() {
+    for (int node = 0; node < num_nodes; node++) {
+        if (node != node_id) flush_peer(node);
+    }
+}
+
+void ClusterNode::flusher_loop() {
+    while (running) {
+        std::this_thread::sleep_for(std::chrono::microseconds(CLUSTER_FLUSH_INTERVAL_US));
+        flush();
+    }
+}
+
+// ============================================================================
+// RECEIVING - Decode frames and inject into local cores
+// ============================================================================
+
+void ClusterNode::deliver(const ClusterEnvelope& envelope) {
+    auto now = std::chrono::steady_clock::now();
+    uint64_t latency = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now - envelope.msg.timestamp).count());
+
+    if (!system.deliver_message(envelope.msg)) {
+        std::cerr << "[NODE " << node_id << "] Core " << envelope.dest.core
+                  << " rejected message" << std::endl;
+        return;
+    }
+
+    if (envelope.source.node == node_id) {
+        local_messages++;
+        local_latency_ns += latency;
+    } else {
+        remote_messages++;
+        remote_latency_ns += latency;
+    }
+}
+
+void ClusterNode::receiver_loop() {
+    std::vector<pollfd> fds;
+    fds.push_back({listen_fd, POLLIN, 0});
+
+    // Bytes read from each peer but not yet a whole frame, by fd
+    std::unordered_map<int, std::vector<uint8_t>> partial;
+
+    while (running) {
+        if (::poll(fds.data(), fds.size(), 50) <= 0) continue;
+
+        // New peer connections; reads never block, so a stalled peer
+        // holding half a frame cannot stop the others or stop()
+        if (fds[0].revents & POLLIN) {
+            int fd = ::accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK);
+            if (fd >= 0) fds.push_back({fd, POLLIN, 0});
+        }
+
+        for (size_t i = 1; i < fds.size(); i++) {
+            if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+
+            std::vector<uint8_t>& buffer = partial[fds[i].fd];
+            bool open = read_available(fds[i].fd, buffer);
+
+            // Decode every complete frame; keep the tail for the next read
+            bool ok = true;
+            size_t offset = 0;
+            while (ok && buffer.size() - offset >= FRAME_HEADER_SIZE) {
+                uint16_t count = 0;
+                uint32_t body_len = 0;
+                ok = decode_cluster_frame_header(buffer.data() + offset, count, body_len);
+                if (!ok || buffer.size() - offset - FRAME_HEADER_SIZE < body_len) break;
+
+                std::vector<ClusterEnvelope> batch;
+                ok = decode_cluster_frame_body(buffer.data() + offset + FRAME_HEADER_SIZE,
+                                               body_len, count, batch);
+                if (!ok) break;
+                offset += FRAME_HEADER_SIZE + body_len;
+
+                frames_received++;
+                for (const auto& envelope : batch) {
+                    deliver(envelope);
+                }
+            }
+            buffer.erase(buffer.begin(), buffer.begin() + offset);
+
+            if (!open || !ok) {
+                // Peer closed, or spoke a version we do not understand
+                partial.erase(fds[i].fd);
+                ::close(fds[i].fd);
+                fds[i].fd = -1;
+            }
+        }
+
+        fds.erase(std::remove_if(fds.begin() + 1, fds.end(),
+                                 [](const pollfd& p) { return p.fd < 0; }),
+                  fds.end());
+    }
+
+    for (size_t i = 1; i < fds.size(); i++) {
+        ::close(fds[i].fd);
+    }
+}
+
+// ============================================================================
+// REPORTING
+// ============================================================================
+
+void ClusterNode::print_latency_report() {
+    auto avg_us = [](uint64_t total_ns, uint64_t count) {
+        return count ? static_cast<double>(total_ns) / count / 1000.0 : 0.0;
+    };
+
+    std::cout << "\n--- Node " << node_id << " Delivery Latency ---" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  Node-local: " << local_messages << " msgs, avg "
+              << avg_us(local_latency_ns, local_messages) << " us" << std::endl;
+    std::cout << "  Cross-node: " << remote_messages << " msgs, avg "
+              << avg_us(remote_latency_ns, remote_messages) << " us" << std::endl;
+    std::cout << "  Frames:     " << frames_sent << " sent, "
+              << frames_received << " received" << std::endl;
+}
@@ -0,0 +1,193 @@
+#include "multikernel.h"
+#include <algorithm>
+
+// ============================================================================
+// COMBINING FRONT END IMPLEMENTATION
+// ============================================================================
+
+// A thread's slot in one front end. The thread keeps it across calls and
+// gives it back to the pool when it exits.
+struct SlotLease {
+    std::weak_ptr<CombiningSlotPool> pool;
+    int index;
+};
+
+struct ThreadSlotLeases {
+    std::unordered_map<const CombiningFrontEnd*, SlotLease> by_front_end;
+
+    ~ThreadSlotLeases() {
+        for (auto& entry : by_front_end) {
+            // Nothing to return once the front end is gone
+            if (auto pool = entry.second.pool.lock()) {
+                std::lock_guard<std::mutex> lock(pool->mutex);
+                pool->free_slots.push_back(entry.second.index);
+            }
+        }
+    }
+};
+
+static thread_local ThreadSlotLeases slot_leases;
+
+// Compares control blocks, which a weak_ptr keeps alive, so a new front end
+// at a dead one's address never matches its old leases
+static bool same_pool(const std::weak_ptr<CombiningSlotPool>& a,
+                      const std::shared_ptr<CombiningSlotPool>& b) {
+    return !a.owner_before(b) && !b.owner_before(a);
+}
+
+CombiningFrontEnd::CombiningFrontEnd(MultikernelSystem& sys)
+    : system(sys), slots(MAX_COMBINER_CLIENTS),
+      pool(std::make_shared<CombiningSlotPool>()) {}
+
+CombiningSlot* CombiningFrontEnd::acquire_slot() {
+    auto& leases = slot_leases.by_front_end;
+    auto it = leases.find(this);
+    if (it != leases.end() && same_pool(it->second.pool, pool)) {
+        return &slots[it->second.index];
+    }
+
+    // First call from this thread: drop leases on front ends that are gone
+    for (auto stale = leases.begin(); stale != leases.end();) {
+        if (stale->second.pool.expired()) {
+            stale = leases.erase(stale);
+        } else {
+            ++stale;
+        }
+    }
+
+    int index = lease_slot();
+    if (index < 0) {
+        return nullptr;
+    }
+    leases[this] = SlotLease{pool, index};
+    return &slots[index];
+}
+
+int CombiningFrontEnd::lease_slot() {
+    std::lock_guard<std::mutex> lock(pool->mutex);
+
+    // Reuse a slot from an exited thread before growing the scanned range
+    if (!pool->free_slots.empty()) {
+        int index = pool->free_slots.back();
+        pool->free_slots.pop_back();
+        return index;
+    }
+
+    int index = registered_slots.load();
+    if (index >= MAX_COMBINER_CLIENTS) {
+        return -1;
+    }
+    registered_slots.store(index + 1);
+    return index;
+}
+
+// ============================================================================
+// CLIENT SIDE - Publish and wait
+// ============================================================================
+
+int CombiningFrontEnd::create_process(int priority) {
+    CombiningSlot* slot = acquire_slot();
+    if (!slot) {
+        // More clients than slots: fall back to a direct call
+        return system.create_process(priority);
+    }
+
+    slot->op = COMBINE_CREATE;
+    slot->priority = priority;
+    slot->state.store(SLOT_PENDING, std::memory_order_release);
+
+    wait_for(slot);
+
+    int pid = slot->result;
+    slot->state.store(SLOT_FREE, std::memory_order_relaxed);
+    return pid;
+}
+
+void CombiningFrontEnd::balance_load() {
+    CombiningSlot* slot = acquire_slot();
+    if (!slot) {
+        system.balance_load();
+        return;
+    }
+
+    slot->op = COMBINE_BALANCE;
+    slot->state.store(SLOT_PENDING, std::memory_order_release);
+
+    wait_for(slot);
+
+    slot->state.store(SLOT_FREE, std::memory_order_relaxed);
+}
+
+void CombiningFrontEnd::wait_for(CombiningSlot* slot) {
+    // Let the other clients publish before anyone combines. Without this a
+    // client usually serves only itself: a combine pass is short next to a
+    // scheduler slice, so the others rarely have a request pending.
+    std::this_thread::yield();
+
+    while (slot->state.load(std::memory_order_acquire) != SLOT_DONE) {
+        // Become the combiner if nobody is, otherwise let it serve us
+        if (combiner_mutex.try_lock()) {
+            combine();
+            combiner_mutex.unlock();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+// ============================================================================
+// COMBINER - Serve every pending slot in one pass
+// ============================================================================
+
+void CombiningFrontEnd::combine() {
+    std::vector<CombiningSlot*> creates;
+    std::vector<CombiningSlot*> balances;
+
+    int used = std::min(registered_slots.load(), MAX_COMBINER_CLIENTS);
+    for (int i = 0; i < used; i++) {
+        CombiningSlot& slot = slots[i];
+        if (slot.state.load(std::memory_order_acquire) != SLOT_PENDING) continue;
+
+        if (slot.op == COMBINE_CREATE) {
+            creates.push_back(&slot);
+        } else {
+            balances.push_back(&slot);
+        }
+    }
+
+    if (creates.empty() && balances.empty()) return;
+
+    if (!creates.empty()) {
+        std::vector<int> priorities;
+        for (auto* slot : creates) {
+            priorities.push_back(slot->priority);
+        }
+
+        std::vector<int> pids;
+        system.create_process_batch(priorities, pids);
+        for (size_t i = 0; i < creates.size(); i++) {
+            creates[i]->result = pids[i];
+        }
+    }
+
+    // Concurrent balance requests all see the same state; one pass serves them
+    if (!balances.empty()) {
+        system.balance_load();
+    }
+
+    for (auto* slot : creates) {
+        slot->state.store(SLOT_DONE, std::memory_order_release);
+    }
+    for (auto* slot : balances) {
+        slot->state.store(SLOT_DONE, std::memory_order_release);
+    }
+
+    combine_passes++;
+    combined_requests += creates.size() + balances.size();
+}
+
+double CombiningFrontEnd::get_average_batch() const {
+    uint64_t passes = combine_passes.load();
+    if (passes == 0) return 0.0;
+    return static_cast<double>(combined_requests.load()) / passes;
+}
@@ -1,135 +1,1222 @@
 #include "multikernel.h"
 #include <algorithm>
 #include <random>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 // ============================================================================
 // CORE KERNEL IMPLEMENTATION
 // ============================================================================
 
+static_assert(alignof(CoreKernel) == CACHE_LINE_SIZE,
+              "CoreKernel regions must start on cache-line boundaries");
+
 CoreKernel::CoreKernel(int id) 
-    : core_id(id), running(false), all_cores(nullptr) {
+    : core_id(id), running(false), worker_id(std::thread::id()), all_cores(nullptr),
+      arena(std::make_shared<HugePageArena>()), rx_channels(NUM_CORES),
+      rx_deficit(NUM_CORES, 0), tx_channels(NUM_CORES), tx_open_sent_ms(NUM_CORES, 0),
+      coalesce_buf(NUM_CORES), coalesce_due_ns(NUM_CORES, INT64_MAX) {
     process_table.reserve(MAX_PROCESSES / NUM_CORES);
+    inbox_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+}
+
+CoreKernel::~CoreKernel() {
+    stop();
+    if (inbox_fd >= 0) close(inbox_fd);
+}
+
+void CoreKernel::start(std::vector<CoreKernel*>* cores, InterconnectModel* model,
+                       TopicDirectory* directory, ProcessDirectory* pids,
+                       NameService* registry) {
+    if (running) return;
+    
+    all_cores = cores;
+    interconnect = model;
+    topics = directory;
+    processes = pids;
+    names = registry;
+    running = true;
+    
+    // Launch worker thread for this core
+    worker_thread = std::thread(&CoreKernel::worker_loop, this);
+    
+    std::cout << "[Core " << core_id << "] Started successfully" << std::endl;
+}
+
+void CoreKernel::stop() {
+    // The worker may already have cleared running on MSG_SHUTDOWN, so key
+    // off the thread rather than the flag
+    if (!worker_thread.joinable()) return;
+    
+    running = false;
+    signal_inbox();
+    { std::lock_guard<std::mutex> lock(inbox_mutex); }
+    inbox_cv.notify_all();
+    
+    worker_thread.join();
+    
+    std::cout << "[Core " << core_id << "] Stopped" << std::endl;
+}
+
+// ============================================================================
+// MESSAGE PASSING - Inter-core communication
+// ============================================================================
+
+// Control traffic always rides the bootstrap channel so it never needs a
+// handshake of its own
+static bool is_control_message(const Message& msg) {
+    return msg.type == MSG_CHANNEL_OPEN || msg.type == MSG_CHANNEL_ACK ||
+           msg.type == MSG_SHUTDOWN;
+}
+
+// Urgent traffic (shutdown, migration commits, anything the sender flags)
+// preempts the receiver's scheduler pass instead of waiting for its end
+static bool is_urgent(const Message& msg) {
+    return msg.urgent || msg.type == MSG_SHUTDOWN;
+}
+
+// The bootstrap channel is drained before any per-pair channel, so it is
+// also the express lane for urgent messages
+static bool rides_bootstrap(const Message& msg) {
+    return is_control_message(msg) || is_urgent(msg);
+}
+
+// Dedicated liveness beats on idle links are tagged, so a receiver can tell
+// them from regular traffic that happens to use MSG_HEARTBEAT
+static const char IDLE_HEARTBEAT_TAG[] = "idle";
+
+static bool is_idle_heartbeat(const Message& msg) {
+    return msg.type == MSG_HEARTBEAT && strcmp(msg.data, IDLE_HEARTBEAT_TAG) == 0;
+}
+
+bool CoreKernel::send_message(const Message& msg) {
+    if (msg.dest_core < 0 || msg.dest_core >= NUM_CORES) {
+        std::cerr << "[Core " << core_id << "] Invalid destination core: " 
+                  << msg.dest_core << std::endl;
+        return false;
+    }
+    
+    if (!all_cores || msg.dest_core >= static_cast<int>(all_cores->size())) {
+        std::cerr << "[Core " << core_id << "] Core system not initialized" << std::endl;
+        return false;
+    }
+    
+    // Same-core fast path: the worker messaging itself needs no lock, no
+    // wakeup and no link; it picks the message up in this same iteration
+    if (msg.dest_core == core_id && on_worker_thread()) {
+        local_queue.push_back(msg);
+        stats.messages_sent++;
+        stats.self_messages++;
+        return true;
+    }
+    
+    // Under the interconnect model, reserve the link and stamp when the
+    // receiver may see the message
+    if (interconnect) {
+        Message modeled = msg;
+        modeled.deliver_at = interconnect->schedule(core_id, msg.dest_core, wire_size(msg),
+                                                    std::chrono::steady_clock::now());
+        return transmit(modeled);
+    }
+    return transmit(msg);
+}
+
+bool CoreKernel::transmit(const Message& msg) {
+    if (rides_bootstrap(msg) || msg.type < 0 || msg.type >= MSG_TYPE_COUNT) {
+        return route_message(msg);
+    }
+    
+    int delay_us = coalesce_delay_us[msg.type].load(std::memory_order_relaxed);
+    if (delay_us > 0) {
+        return coalesce(msg, delay_us);
+    }
+    
+    // Earlier sends to this destination may still be held; they go first
+    if (coalesce_held[msg.dest_core].load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(coalesce_mutex);
+        publish_locked(msg.dest_core);
+        return route_message(msg);
+    }
+    return route_message(msg);
+}
+
+// ============================================================================
+// SEND COALESCING - Hold small sends briefly, publish them as one unit
+// ============================================================================
+
+void CoreKernel::set_coalescing(MessageType type, int max_delay_us, int max_batch) {
+    if (type < 0 || type >= MSG_TYPE_COUNT) return;
+    coalesce_batch[type].store(std::max(1, std::min(max_batch, COALESCE_MAX_BATCH)));
+    coalesce_delay_us[type].store(std::max(0, max_delay_us));
+}
+
+bool CoreKernel::coalesce(const Message& msg, int delay_us) {
+    int dest = msg.dest_core;
+    int64_t due = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count() +
+        static_cast<int64_t>(delay_us) * 1000;
+    bool earlier = false;
+    
+    stats.coalesced_messages++;
+    {
+        // Publishing under the lock keeps held and direct sends in order
+        std::lock_guard<std::mutex> lock(coalesce_mutex);
+        auto& buf = coalesce_buf[dest];
+        buf.push_back(msg);
+        coalesce_held[dest].store(true, std::memory_order_release);
+        coalesce_due_ns[dest] = std::min(coalesce_due_ns[dest], due);
+        
+        if (static_cast<int>(buf.size()) >= coalesce_batch[msg.type].load()) {
+            publish_locked(dest);
+        } else if (due < coalesce_next_due_ns.load()) {
+            coalesce_next_due_ns.store(due);
+            earlier = true;
+        }
+    }
+    
+    // The worker publishes on time; make it notice the earlier deadline
+    if (earlier) kick();
+    
+    // The sender has moved on by the time the unit is published, so pushback
+    // cannot be returned here; publish_locked counts it in coalesced_refused
+    return true;
+}
+
+void CoreKernel::publish_locked(int dest_core) {
+    auto& buf = coalesce_buf[dest_core];
+    if (buf.empty()) return;
+    
+    std::vector<Message> unit;
+    unit.swap(buf);
+    coalesce_due_ns[dest_core] = INT64_MAX;
+    coalesce_held[dest_core].store(false, std::memory_order_release);
+    
+    stats.coalesced_units++;
+    stats.coalesced_refused += send_batch(dest_core, unit);
+}
+
+void CoreKernel::publish_due(bool force) {
+    int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    if (!force && now < coalesce_next_due_ns.load()) return;
+    
+    std::lock_guard<std::mutex> lock(coalesce_mutex);
+    int64_t next = INT64_MAX;
+    for (int dest = 0; dest < NUM_CORES; dest++) {
+        if (coalesce_buf[dest].empty()) continue;
+        if (force || coalesce_due_ns[dest] <= now) {
+            publish_locked(dest);
+        } else {
+            next = std::min(next, coalesce_due_ns[dest]);
+        }
+    }
+    coalesce_next_due_ns.store(next);
+}
+
+void CoreKernel::kick() {
+    kicked.store(true);
+    if (inbox_armed.exchange(false)) signal_inbox();
+    if (sleepers.load() > 0) {
+        { std::lock_guard<std::mutex> lock(inbox_mutex); }
+        // Other receivers may be parked too; the worker must be among those woken
+        inbox_cv.notify_all();
+    }
+}
+
+bool CoreKernel::route_message(const Message& msg) {
+    // Route message to destination core
+    CoreKernel* dest = (*all_cores)[msg.dest_core];
+    if (!dest) return false;
+    
+    if (rides_bootstrap(msg)) {
+        if (dest->post_bootstrap(msg, own_meta())) {
+            note_wake(dest->wake());
+            stats.messages_sent++;
+            return true;
+        }
+        std::cerr << "[Core " << core_id << "] Destination queue full" << std::endl;
+        return false;
+    }
+    
+    // Fast path: the channel to this destination is already established
+    std::shared_ptr<Channel> channel;
+    {
+        std::lock_guard<std::mutex> lock(tx_mutex);
+        channel = tx_channels[msg.dest_core];
+    }
+    
+    if (channel) {
+        if (channel->push(msg, own_meta())) {
+            dest->pending_messages++;
+            note_wake(dest->wake());
+            stats.messages_sent++;
+            stats.wire_messages++;
+            stats.wire_bytes += wire_size(msg);
+            return true;
+        }
+        
+        // A full channel is this sender's quota at the receiver: push back
+        // on the sender rather than crowd out everyone else
+        if (!channel->is_closed()) {
+            stats.messages_refused++;
+            return false;
+        }
+        
+        // The receiver reclaimed the idle channel; forget it and reconnect
+        std::lock_guard<std::mutex> lock(tx_mutex);
+        if (tx_channels[msg.dest_core] == channel) {
+            tx_channels[msg.dest_core].reset();
+        }
+    }
+    
+    // No channel yet: start (or retry) the handshake, and meanwhile deliver
+    // through the bootstrap channel so nothing waits on the setup
+    bool send_open = false;
+    {
+        std::lock_guard<std::mutex> lock(tx_mutex);
+        int64_t now = steady_now_ms();
+        int64_t& sent_at = tx_open_sent_ms[msg.dest_core];
+        if (sent_at == 0 || now - sent_at >= CHANNEL_IDLE_TIMEOUT_MS) {
+            sent_at = now;
+            send_open = true;
+        }
+    }
+    
+    if (send_open) {
+        Message open_msg;
+        open_msg.source_core = core_id;
+        open_msg.dest_core = msg.dest_core;
+        open_msg.type = MSG_CHANNEL_OPEN;
+        if (dest->post_bootstrap(open_msg, own_meta())) {
+            note_wake(dest->wake());
+        } else {
+            std::lock_guard<std::mutex> lock(tx_mutex);
+            tx_open_sent_ms[msg.dest_core] = 0;
+        }
+    }
+    
+    if (dest->post_bootstrap(msg, own_meta())) {
+        note_wake(dest->wake());
+        stats.messages_sent++;
+        return true;
+    }
+    stats.messages_refused++;
+    return false;
+}
+
+size_t CoreKernel::send_batch(int dest_core, const std::vector<Message>& msgs) {
+    CoreKernel* dest = (*all_cores)[dest_core];
+    if (!dest) return msgs.size();
+    
+    std::shared_ptr<Channel> channel;
+    {
+        std::lock_guard<std::mutex> lock(tx_mutex);
+        channel = tx_channels[dest_core];
+    }
+    
+    // One lock, one counter update and at most one wakeup for the whole run
+    size_t pushed = channel ? channel->push_batch(msgs.data(), msgs.size(), own_meta()) : 0;
+    if (pushed > 0) {
+        dest->pending_messages += static_cast<int>(pushed);
+        note_wake(dest->wake());
+        stats.messages_sent += pushed;
+        if (pushed > 1) stats.batched_pushes++;
+        
+        size_t bytes = 0;
+        for (size_t i = 0; i < pushed; i++) bytes += wire_size(msgs[i]);
+        stats.wire_messages += pushed;
+        stats.wire_bytes += bytes;
+    }
+    
+    // Whatever did not fit, or has no channel yet, takes the single-message
+    // path, which handles the handshake, reclaimed channels and pushback
+    size_t refused = 0;
+    for (size_t i = pushed; i < msgs.size(); i++) {
+        if (!route_message(msgs[i])) refused++;
+    }
+    return refused;
+}
+
+void CoreKernel::stage_message(const Message& msg) {
+    std::lock_guard<std::mutex> lock(outbox_mutex);
+    outbox.push_back(msg);
+}
+
+size_t CoreKernel::flush_outbox() {
+    std::lock_guard<std::mutex> flush_lock(flush_mutex);
+    
+    std::vector<Message> staged;
+    {
+        std::lock_guard<std::mutex> lock(outbox_mutex);
+        staged.swap(outbox);
+    }
+    if (staged.empty()) return 0;
+    
+    stats.outbox_staged += staged.size();
+    stats.outbox_flushes++;
+    
+    // Group data messages per destination, keeping each one's order. Control,
+    // urgent, self-addressed and malformed messages take the normal path.
+    // Staged senders have moved on, so a refusal here is a drop: count it.
+    size_t refused = 0;
+    std::vector<std::vector<Message>> by_dest(NUM_CORES);
+    for (auto& msg : staged) {
+        if (!all_cores || msg.dest_core < 0 || msg.dest_core >= NUM_CORES ||
+            msg.dest_core == core_id || rides_bootstrap(msg)) {
+            if (!send_message(msg)) refused++;
+            continue;
+        }
+        if (interconnect) {
+            msg.deliver_at = interconnect->schedule(core_id, msg.dest_core, wire_size(msg),
+                                                    std::chrono::steady_clock::now());
+        }
+        by_dest[msg.dest_core].push_back(msg);
+    }
+    
+    for (int dest = 0; dest < NUM_CORES; dest++) {
+        if (by_dest[dest].empty()) continue;
+        
+        if (coalesce_held[dest].load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(coalesce_mutex);
+            publish_locked(dest);
+            refused += send_batch(dest, by_dest[dest]);
+        } else {
+            refused += send_batch(dest, by_dest[dest]);
+        }
+    }
+    
+    stats.outbox_refused += refused;
+    return refused;
+}
+
+bool CoreKernel::deliver_external(const Message& msg) {
+    // External links have no per-pair channel; they share the bootstrap one.
+    // There is no sending core here to charge the wakeup to.
+    if (!post_bootstrap(msg, PeerMeta(), true)) return false;
+    wake();
+    return true;
+}
+
+bool CoreKernel::post_bootstrap(const Message& msg, const PeerMeta& meta, bool external) {
+    {
+        std::lock_guard<std::mutex> lock(inbox_mutex);
+        
+        // Check queue size to prevent overflow
+        if (inbox.size() >= MESSAGE_QUEUE_SIZE) {
+            return false;
+        }
+        
+        // Data messages from one source may only take a share of the inbox,
+        // so a flood before its channel opens cannot lock the others out.
+        // Control and urgent messages are exempt: they must always get through.
+        // External traffic shares one slot of its own, so core N on another
+        // node cannot use up the quota of local core N.
+        int slot = -1;
+        if (!rides_bootstrap(msg)) {
+            if (external) {
+                slot = EXTERNAL_QUOTA_SLOT;
+            } else if (msg.source_core >= 0 && msg.source_core < NUM_CORES) {
+                slot = msg.source_core;
+            }
+        }
+        if (slot >= 0) {
+            if (inbox_by_source[slot] >= BOOTSTRAP_SOURCE_QUOTA) {
+                return false;
+            }
+            inbox_by_source[slot]++;
+        }
+        
+        inbox.push({msg, slot});
+        inbox.back().msg.sender_load = meta.load;
+        inbox.back().msg.sender_epoch = meta.epoch;
+        pending_messages++;
+    }
+    if (is_urgent(msg)) {
+        preempt_requested.store(true, std::memory_order_release);
+    }
+    return true;
+}
+
+bool CoreKernel::wake() {
+    // The worker parks on its WaitSet. It arms the inbox before testing
+    // pending_messages, the mirror of the check below, and the first sender
+    // to find it armed writes the eventfd for everyone.
+    bool notified = false;
+    if (inbox_armed.load() && inbox_armed.exchange(false)) {
+        signal_inbox();
+        notified = true;
+    }
+    
+    // Other receivers park on inbox_cv. They bump `sleepers` before testing
+    // pending_messages, and senders bump pending_messages before testing
+    // `sleepers`, so either the receiver sees the message or we see the
+    // receiver. An awake receiver will find the message on its next pass and
+    // needs no notify, and until a parked receiver re-arms, one notify is
+    // enough for every sender.
+    if (sleepers.load() == 0 || wake_pending.exchange(true)) {
+        return notified;
+    }
+    
+    // Taking the lock orders us after a receiver that is between its
+    // predicate check and the wait
+    { std::lock_guard<std::mutex> lock(inbox_mutex); }
+    inbox_cv.notify_one();
+    return true;
+}
+
+void CoreKernel::signal_inbox() {
+    uint64_t one = 1;
+    if (inbox_fd >= 0 && write(inbox_fd, &one, sizeof(one)) < 0) {
+        // Counter saturated; the fd is readable either way
+    }
+}
+
+int CoreKernel::watch_inbox() const {
+    return on_worker_thread() ? inbox_fd : -1;
+}
+
+void CoreKernel::arm_inbox() {
+    if (inbox_fd < 0) return;
+    
+    // Reset the counter, then arm. Arming before checking pending_messages
+    // pairs with senders bumping it before checking the flag (see wake()).
+    uint64_t count;
+    while (read(inbox_fd, &count, sizeof(count)) > 0) {}
+    
+    inbox_armed.store(true);
+    if ((pending_messages > inbox_backlog || !running || kicked) && inbox_armed.exchange(false)) {
+        signal_inbox();
+    }
+}
+
+void CoreKernel::note_wake(bool notified) {
+    // Counted on the sending side, so the receiver's statistics line is not
+    // written by every core that sends to it
+    if (notified) {
+        stats.wakeups_sent++;
+    } else {
+        stats.wakeups_suppressed++;
+    }
+}
+
+void CoreKernel::park_until(std::chrono::steady_clock::time_point deadline, int backlog) {
+    // The worker waits on its WaitSet, everyone else on the condvar
+    if (worker_waits && on_worker_thread()) {
+        inbox_backlog = backlog;
+        worker_waits->wait_until(worker_ready, deadline);
+        inbox_armed.store(false);   // Awake now; senders need not signal
+        inbox_backlog = 0;
+        return;
+    }
+    
+    std::unique_lock<std::mutex> lock(inbox_mutex);
+    sleepers++;
+    wake_pending.store(false);  // Re-arm before the predicate check, not after
+    inbox_cv.wait_until(lock, deadline,
+                        [this, backlog] {
+                            return pending_messages > backlog || !running || kicked;
+                        });
+    sleepers--;
+}
+
+void CoreKernel::pop_bootstrap(Message& msg) {
+    msg = inbox.front().msg;
+    if (inbox.front().quota_slot >= 0) {
+        inbox_by_source[inbox.front().quota_slot]--;
+    }
+    inbox.pop();
+    pending_messages--;
+}
+
+
+bool CoreKernel::on_worker_thread() const {
+    return std::this_thread::get_id() == worker_id.load(std::memory_order_relaxed);
+}
+
+bool CoreKernel::pop_any(Message& msg) {
+    if (!local_queue.empty() && on_worker_thread()) {
+        msg = local_queue.front();
+        local_queue.pop_front();
+        return true;
+    }
+    
+    if (interconnect) {
+        return pop_modeled(msg);
+    }
+    
+    // Bootstrap first: anything sent there predates the channel from the
+    // same source, so this keeps per-pair FIFO order across the switch
+    {
+        std::lock_guard<std::mutex> lock(inbox_mutex);
+        if (!inbox.empty()) {
+            pop_bootstrap(msg);
+            return true;
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(rx_mutex);
+    if (pop_fair(msg)) {
+        pending_messages--;
+        return true;
+    }
+    
+    return false;
+}
+
+bool CoreKernel::pop_fair(Message& msg) {
+    // Deficit round-robin over the inbound channels: each source gets
+    // DRR_QUANTUM_BYTES of credit per round and is served while its head
+    // message fits, so a source sending large or many messages cannot take
+    // more than its share of this core's receive time. One full lap plus a
+    // revisit of the starting source is enough to find any queued message.
+    size_t sources = rx_channels.size();
+    for (size_t visited = 0; visited <= sources; visited++) {
+        Channel* channel = rx_channels[rx_cursor].get();
+        size_t bytes;
+        
+        if (channel && channel->peek_size(bytes)) {
+            if (!rx_turn_open) {
+                rx_deficit[rx_cursor] += DRR_QUANTUM_BYTES;
+                rx_turn_open = true;
+            }
+            if (bytes <= rx_deficit[rx_cursor] && channel->pop(msg)) {
+                rx_deficit[rx_cursor] -= bytes;
+                return true;
+            }
+        } else {
+            // An empty source does not bank credit for later bursts
+            rx_deficit[rx_cursor] = 0;
+        }
+        
+        rx_turn_open = false;
+        rx_cursor = (rx_cursor + 1) % sources;
+    }
+    
+    return false;
+}
+
+bool CoreKernel::pop_modeled(Message& msg) {
+    // Deliver the earliest modeled arrival; in real-time mode only once it
+    // is due. Ties go to the bootstrap channel to keep per-pair FIFO order.
+    auto now = std::chrono::steady_clock::now();
+    bool virtual_time = interconnect->is_virtual_time();
+    
+    std::lock_guard<std::mutex> rx_lock(rx_mutex);
+    
+    std::chrono::steady_clock::time_point best = std::chrono::steady_clock::time_point::max();
+    int best_source = -1;   // -1 selects the bootstrap channel
+    bool found = false;
+    
+    {
+        std::lock_guard<std::mutex> lock(inbox_mutex);
+        if (!inbox.empty()) {
+            best = inbox.front().msg.deliver_at;
+            found = true;
+        }
+    }
+    
+    for (size_t i = 0; i < rx_channels.size(); i++) {
+        std::chrono::steady_clock::time_point when;
+        if (rx_channels[i] && rx_channels[i]->peek_deliver_at(when) && when < best) {
+            best = when;
+            best_source = static_cast<int>(i);
+            found = true;
+        }
+    }
+    
+    if (!found || (!virtual_time && best > now)) {
+        return false;
+    }
+    
+    if (best_source < 0) {
+        std::lock_guard<std::mutex> lock(inbox_mutex);
+        pop_bootstrap(msg);
+    } else {
+        rx_channels[best_source]->pop(msg);
+        pending_messages--;
+    }
+    return true;
+}
+
+// ============================================================================
+// PEER STATE - Piggybacked load and liveness, heartbeats only on idle links
+// ============================================================================
+
+PeerMeta CoreKernel::own_meta() const {
+    PeerMeta meta;
+    meta.load = stats.current_load.load(std::memory_order_relaxed);
+    meta.epoch = epoch.load(std::memory_order_relaxed);
+    return meta;
+}
+
+void CoreKernel::note_peer(const Message& msg) {
+    int source = msg.source_core;
+    if (msg.sender_epoch == 0 || source < 0 || source >= NUM_CORES) return;
+    
+    PeerState& peer = peers[source];
+    peer.load.store(msg.sender_load, std::memory_order_relaxed);
+    peer.epoch.store(msg.sender_epoch, std::memory_order_relaxed);
+    peer.heard_ms.store(steady_now_ms(), std::memory_order_relaxed);
+    if (!is_idle_heartbeat(msg)) stats.peer_updates_piggybacked++;
+}
+
+bool CoreKernel::get_peer_state(int core, int& load, uint32_t& peer_epoch,
+                                int64_t& age_ms) const {
+    if (core < 0 || core >= NUM_CORES) return false;
+    
+    const PeerState& peer = peers[core];
+    int64_t heard = peer.heard_ms.load(std::memory_order_relaxed);
+    if (heard == 0) return false;
+    
+    load = peer.load.load(std::memory_order_relaxed);
+    peer_epoch = peer.epoch.load(std::memory_order_relaxed);
+    age_ms = steady_now_ms() - heard;
+    return true;
+}
+
+void CoreKernel::send_idle_heartbeats() {
+    int64_t now = steady_now_ms();
+    if (now - last_heartbeat_ms < HEARTBEAT_INTERVAL_MS) return;
+    last_heartbeat_ms = now;
+    
+    std::vector<int> idle;
+    {
+        std::lock_guard<std::mutex> lock(tx_mutex);
+        for (int dest = 0; dest < NUM_CORES; dest++) {
+            const auto& channel = tx_channels[dest];
+            if (channel && !channel->is_closed() && channel->is_idle(now, HEARTBEAT_IDLE_MS)) {
+                idle.push_back(dest);
+            }
+        }
+    }
+    
+    // Busy links already carry our load and epoch, and links we never use
+    // need no liveness
+    for (int dest : idle) {
+        // The bootstrap channel leaves the link's idle clock alone, so a
+        // link that stays quiet is still reclaimed
+        Message beat;
+        beat.source_core = core_id;
+        beat.dest_core = dest;
+        beat.type = MSG_HEARTBEAT;
+        beat.set_payload(IDLE_HEARTBEAT_TAG);
+        beat.set_ttl(std::chrono::milliseconds(HEARTBEAT_INTERVAL_MS));
+        if (interconnect) {
+            beat.deliver_at = interconnect->schedule(core_id, dest, wire_size(beat), beat.timestamp);
+        }
+        if ((*all_cores)[dest]->post_bootstrap(beat, own_meta())) {
+            note_wake((*all_cores)[dest]->wake());
+            stats.heartbeats_sent++;
+        }
+    }
+}
+
+// The time a message counts as received: its modeled arrival under a virtual
+// interconnect, else now. External deliveries never went through the model
+// and carry no arrival, so they also count as now.
+std::chrono::steady_clock::time_point CoreKernel::arrival_time(const Message& msg) const {
+    if (interconnect && interconnect->is_virtual_time() &&
+        msg.deliver_at != std::chrono::steady_clock::time_point()) {
+        return msg.deliver_at;
+    }
+    return std::chrono::steady_clock::now();
+}
+
+void CoreKernel::note_received(const Message& msg) {
+    stats.messages_received++;
+    note_peer(msg);
+    
+    auto now = arrival_time(msg);
+    auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+        now - msg.timestamp);
+    stats.avg_message_latency_us.store(latency.count()); 
+    
+    if (is_urgent(msg)) {
+        stats.urgent_messages++;
+        stats.urgent_latency_us += latency.count();
+    }
+}
+
+bool CoreKernel::pop_live(Message& msg) {
+    // Expired messages are dropped here, before any handler sees them, so an
+    // overloaded core spends its time on fresh work. Control messages carry
+    // no deadline and always pass.
+    while (pop_any(msg)) {
+        if (!msg.has_deadline()) return true;
+        
+        if (!msg.expired(arrival_time(msg))) return true;
+        
+        stats.messages_expired++;
+    }
+    return false;
+}
+
+bool CoreKernel::receive_message(Message& msg, int timeout_ms) {
+    if (pop_live(msg)) {
+        note_received(msg);
+        return true;
+    }
+    
+    if (timeout_ms > 0) {
+        // Wait with timeout
+        park_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms), 0);
+        
+        if (pop_live(msg)) {
+            note_received(msg);
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+// ============================================================================
+// PUBLISH / SUBSCRIBE
+// ============================================================================
+
+int CoreKernel::subscribe(const std::string& topic,
+                          std::function<void(const Message&)> handler) {
+    if (!topics) return -1;
+    
+    int id = topics->lookup(topic);
+    if (id < 0) return -1;
+    
+    // Install the handler before publishers can see our bit
+    {
+        std::lock_guard<std::mutex> lock(topic_mutex);
+        topic_handlers[id] = std::move(handler);
+    }
+    topics->subscribe(id, core_id);
+    return id;
+}
+
+void CoreKernel::unsubscribe(int topic) {
+    if (!topics || topic < 0 || topic >= MAX_TOPICS) return;
+    
+    topics->unsubscribe(topic, core_id);
+    
+    std::lock_guard<std::mutex> lock(topic_mutex);
+    topic_handlers.erase(topic);
+}
+
+int CoreKernel::publish(int topic, const Message& msg) {
+    int reached = stage_publish(topic, msg);
+    flush_outbox();
+    return reached;
+}
+
+int CoreKernel::stage_publish(int topic, const Message& msg) {
+    if (!topics || topic < 0 || topic >= MAX_TOPICS) return 0;
+    
+    uint64_t mask = topics->subscribers_of(topic);
+    stats.topic_published++;
+    if (mask == 0) return 0;
+    
+    // One copy per subscriber, all staged so they leave in one flush
+    int reached = 0;
+    for (int core = 0; core < NUM_CORES; core++) {
+        if (!(mask & (1ULL << core))) continue;
+        
+        Message update = msg;
+        update.type = MSG_TOPIC_UPDATE;
+        update.topic = topic;
+        update.source_core = core_id;
+        update.dest_core = core;
+        stage_message(update);
+        reached++;
+    }
+    
+    stats.topic_fanout += reached;
+    return reached;
+}
+
+void CoreKernel::handle_topic_update(const Message& msg) {
+    std::function<void(const Message&)> handler;
+    {
+        std::lock_guard<std::mutex> lock(topic_mutex);
+        auto it = topic_handlers.find(msg.topic);
+        if (it != topic_handlers.end()) handler = it->second;
+    }
+    
+    // Published before we unsubscribed, delivered after: nobody wants it
+    if (!handler) {
+        stats.topic_dropped++;
+        return;
+    }
+    
+    handler(msg);
+    stats.topic_delivered++;
+}
+
+void CoreKernel::broadcast_message(const Message& msg) {
+    for (int i = 0; i < NUM_CORES; i++) {
+        if (i != core_id) {
+            Message broadcast_msg = msg;
+            broadcast_msg.dest_core = i;
+            stage_message(broadcast_msg);
+        }
+    }
+    flush_outbox();
+}
+
+// ============================================================================
+// TIMERS - One-shot callbacks on the worker, kept in a hierarchical wheel
+// ============================================================================
+
+uint64_t CoreKernel::set_timer(std::chrono::microseconds delay, std::function<void()> callback) {
+    auto when = std::chrono::steady_clock::now() + delay;
+    
+    // Lateness is measured against the time asked for, not the tick it landed on
+    auto fire = [this, when, callback = std::move(callback)]() {
+        stats.timer_lateness_us += std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - when).count();
+        stats.timers_fired++;
+        callback();
+    };
+    
+    uint64_t id;
+    bool earlier;
+    {
+        std::lock_guard<std::mutex> lock(timer_mutex);
+        auto before = timers.next_deadline();
+        id = timers.schedule(when, std::move(fire));
+        earlier = timers.next_deadline() < before;
+    }
+    stats.timers_set++;
+    
+    // The worker may be parked past this one; make it recompute its deadline
+    if (earlier && !on_worker_thread()) kick();
+    return id;
+}
+
+bool CoreKernel::cancel_timer(uint64_t id) {
+    bool cancelled;
+    {
+        std::lock_guard<std::mutex> lock(timer_mutex);
+        cancelled = timers.cancel(id);
+    }
+    if (cancelled) stats.timers_cancelled++;
+    return cancelled;
+}
+
+void CoreKernel::fire_timers() {
+    {
+        std::lock_guard<std::mutex> lock(timer_mutex);
+        timers.advance(std::chrono::steady_clock::now(), timers_due);
+    }
+    
+    // Outside the lock, so callbacks may set or cancel timers themselves
+    for (auto& callback : timers_due) {
+        callback();
+    }
+    timers_due.clear();
+}
+
+// ============================================================================
+// PROCESS MAILBOXES - Mail between processes, addressed by PID
+// ============================================================================
+
+// Mailboxes stay in send order. Mail forwarded after a migration can land
+// behind newer mail from the same sender; the send time puts it back.
+static void enqueue_mail(ProcessControlBlock& pcb, const Message& msg) {
+    auto pos = pcb.mailbox.end();
+    while (pos != pcb.mailbox.begin() && std::prev(pos)->timestamp > msg.timestamp) {
+        --pos;
+    }
+    pcb.mailbox.insert(pos, msg);
 }
 
-CoreKernel::~CoreKernel() {
-    stop();
+// Wakes receive_mail() waiters and, once per arming, a WaitSet watching the
+// mailbox. Caller holds mailbox_mutex.
+static void signal_mail(ProcessControlBlock& pcb) {
+    pcb.mailbox_cv.notify_all();
+    
+    if (pcb.mail_armed) {
+        pcb.mail_armed = false;
+        uint64_t one = 1;
+        if (write(pcb.mail_fd, &one, sizeof(one)) < 0) {
+            // Counter saturated; the fd is readable either way
+        }
+    }
 }
 
-void CoreKernel::start(std::vector<CoreKernel*>* cores) {
-    if (running) return;
+ProcessControlBlock::~ProcessControlBlock() {
+    if (mail_fd >= 0) close(mail_fd);
+}
+
+std::shared_ptr<ProcessControlBlock> CoreKernel::watch_mailbox(int pid) {
+    std::lock_guard<std::mutex> lock(process_mutex);
+    auto pcb = find_process(pid);
+    if (!pcb) return nullptr;
     
-    all_cores = cores;
-    running = true;
+    std::lock_guard<std::mutex> mail_lock(pcb->mailbox_mutex);
+    if (pcb->mail_fd < 0) {
+        pcb->mail_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (pcb->mail_fd < 0) return nullptr;
+    }
+    return pcb;
+}
+
+void CoreKernel::arm_mailbox(ProcessControlBlock& pcb) {
+    std::lock_guard<std::mutex> mail_lock(pcb.mailbox_mutex);
     
-    // Launch worker thread for this core
-    worker_thread = std::thread(&CoreKernel::worker_loop, this);
+    // Reset the counter, then either signal at once or wait for an arrival
+    uint64_t count;
+    while (read(pcb.mail_fd, &count, sizeof(count)) > 0) {}
     
-    std::cout << "[Core " << core_id << "] Started successfully" << std::endl;
+    pcb.mail_armed = true;
+    if (!pcb.mailbox.empty() || pcb.departed) {
+        signal_mail(pcb);
+    }
 }
 
-void CoreKernel::stop() {
-    if (!running) return;
+bool CoreKernel::send_mail(int pid, const Message& msg) {
+    int owner = processes ? processes->core_of(pid) : -1;
+    if (owner < 0) return false;
     
-    running = false;
-    inbox_cv.notify_all();
+    Message mail = msg;
+    mail.type = MSG_PROCESS_MAIL;
+    mail.process_id = pid;
+    mail.source_core = core_id;
+    mail.dest_core = owner;
+    mail.timestamp = std::chrono::steady_clock::now();
+    stats.mail_sent++;
     
-    if (worker_thread.joinable()) {
-        worker_thread.join();
+    // Same core: straight into the mailbox, no channel and no worker hop
+    if (owner == core_id) {
+        stats.mail_local++;
+        return deliver_mail(mail);
     }
-    
-    std::cout << "[Core " << core_id << "] Stopped" << std::endl;
+    return send_message(mail);
 }
 
-// ============================================================================
-// MESSAGE PASSING - Inter-core communication
-// ============================================================================
-
-void CoreKernel::send_message(const Message& msg) {
-    if (msg.dest_core < 0 || msg.dest_core >= NUM_CORES) {
-        std::cerr << "[Core " << core_id << "] Invalid destination core: " 
-                  << msg.dest_core << std::endl;
-        return;
+bool CoreKernel::receive_mail(int pid, Message& msg, int timeout_ms) {
+    std::shared_ptr<ProcessControlBlock> pcb;
+    {
+        std::lock_guard<std::mutex> lock(process_mutex);
+        pcb = find_process(pid);
+        if (!pcb) return false;
+        pcb->has_receiver = true;
+        
+        std::lock_guard<std::mutex> mail_lock(pcb->mailbox_mutex);
+        if (!pcb->mailbox.empty()) {
+            msg = pcb->mailbox.front();
+            pcb->mailbox.pop_front();
+            return true;
+        }
+        if (timeout_ms <= 0) return false;
+        
+        // Off the run queue until mail arrives
+        pcb->state = PROCESS_BLOCKED;
     }
     
-    if (!all_cores || msg.dest_core >= all_cores->size()) {
-        std::cerr << "[Core " << core_id << "] Core system not initialized" << std::endl;
-        return;
+    bool got = false;
+    {
+        std::unique_lock<std::mutex> mail_lock(pcb->mailbox_mutex);
+        pcb->mailbox_cv.wait_for(mail_lock, std::chrono::milliseconds(timeout_ms),
+                                 [&pcb] { return !pcb->mailbox.empty() || pcb->departed; });
+        if (!pcb->mailbox.empty() && !pcb->departed) {
+            msg = pcb->mailbox.front();
+            pcb->mailbox.pop_front();
+            got = true;
+        }
     }
     
-    // Route message to destination core
-    CoreKernel* dest = (*all_cores)[msg.dest_core];
-    if (dest) {
-        std::unique_lock<std::mutex> lock(dest->inbox_mutex);
+    // Delivery already made it ready; a timeout has to do it here
+    if (!got) {
+        std::lock_guard<std::mutex> lock(process_mutex);
+        if (pcb->state == PROCESS_BLOCKED) pcb->state = PROCESS_READY;
+    }
+    return got;
+}
+
+bool CoreKernel::deliver_mail(const Message& msg) {
+    bool forward = false;
+    bool delivered = false;
+    {
+        std::lock_guard<std::mutex> lock(process_mutex);
+        auto pcb = find_process(msg.process_id);
         
-        // Check queue size to prevent overflow
-        if (dest->inbox.size() >= MESSAGE_QUEUE_SIZE) {
-            std::cerr << "[Core " << core_id << "] Destination queue full" << std::endl;
-            return;
+        if (!pcb) {
+            // Moved on: chase it. The directory only names a core once the
+            // PCB is installed there, so there is nothing to hold for later.
+            int owner = processes ? processes->core_of(msg.process_id) : -1;
+            if (owner >= 0 && owner != core_id) {
+                Message mail = msg;
+                mail.source_core = core_id;
+                mail.dest_core = owner;
+                stage_message(mail);
+                stats.mail_forwarded++;
+                forward = true;
+            }
+        } else {
+            std::lock_guard<std::mutex> mail_lock(pcb->mailbox_mutex);
+            if (pcb->mailbox.size() < PROCESS_MAILBOX_CAPACITY) {
+                enqueue_mail(*pcb, msg);
+                if (pcb->state == PROCESS_BLOCKED) pcb->state = PROCESS_READY;
+                signal_mail(*pcb);
+                stats.mail_delivered++;
+                delivered = true;
+            }
         }
-        
-        dest->inbox.push(msg);
-        dest->inbox_cv.notify_one();
-        
-        stats.messages_sent++;
     }
+    
+    if (forward) {
+        flush_outbox();
+        return true;
+    }
+    if (!delivered) stats.mail_dropped++;
+    return delivered;
 }
 
-bool CoreKernel::receive_message(Message& msg, int timeout_ms) {
-    std::unique_lock<std::mutex> lock(inbox_mutex);
+std::shared_ptr<ProcessControlBlock> CoreKernel::find_process(int pid) {
+    auto it = std::find_if(process_table.begin(), process_table.end(),
+                          [pid](const auto& pcb) { return pcb->pid == pid; });
+    return it != process_table.end() ? *it : nullptr;
+}
+
+void CoreKernel::release_process(ProcessControlBlock& pcb) {
+    if (processes) processes->remove(pcb.pid, core_id);
+    if (names) announce_names(names->release(pcb.pid));
     
-    if (timeout_ms > 0) {
-        // Wait with timeout
-        if (inbox_cv.wait_for(lock, std::chrono::milliseconds(timeout_ms),
-                              [this] { return !inbox.empty() || !running; })) {
-            if (!inbox.empty()) {
-                msg = inbox.front();
-                inbox.pop();
-                stats.messages_received++;
-                
-                // Calculate latency
-                auto now = std::chrono::steady_clock::now();
-                auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
-                    now - msg.timestamp);
-                stats.avg_message_latency_us.store(latency.count()); 
-                
-                return true;
-            }
+    std::lock_guard<std::mutex> mail_lock(pcb.mailbox_mutex);
+    pcb.departed = true;
+    signal_mail(pcb);
+}
+
+// ============================================================================
+// NAME SERVICE - Registry lookups, cached per core
+// ============================================================================
+
+bool CoreKernel::register_service(const std::string& name, int port, int owner_pid) {
+    if (!names || name.empty() || name.size() >= MAX_SERVICE_NAME) return false;
+    join_names_topic();
+    
+    ServiceAddress address;
+    address.core = core_id;
+    address.port = port;
+    NameService::Change change = names->bind(name, address, owner_pid);
+    
+    cache_name(change.name, change.address, change.generation);
+    announce_names({change});
+    flush_outbox();
+    return true;
+}
+
+bool CoreKernel::unregister_service(const std::string& name) {
+    if (!names) return false;
+    join_names_topic();
+    
+    NameService::Change change;
+    if (!names->unbind(name, change)) return false;
+    
+    cache_name(change.name, change.address, change.generation);
+    announce_names({change});
+    flush_outbox();
+    return true;
+}
+
+bool CoreKernel::resolve(const std::string& name, ServiceAddress& address) {
+    if (!names) return false;
+    
+    // Subscribe before reading the registry, so no later change can miss us
+    if (names_topic.load(std::memory_order_relaxed) < 0) join_names_topic();
+    
+    if (on_worker_thread()) {
+        // The owner reads its own copy without the lock and refreshes it only
+        // after a change; names change far less often than they are resolved
+        if (name_epoch.load(std::memory_order_acquire) != worker_names_epoch) {
+            std::lock_guard<std::mutex> lock(name_mutex);
+            worker_names = name_cache;
+            worker_names_epoch = name_epoch.load(std::memory_order_relaxed);
+        }
+        auto it = worker_names.find(name);
+        if (it != worker_names.end()) {
+            // Single writer, so a plain store; get_statistics() adds it in
+            worker_name_hits.store(worker_name_hits.load(std::memory_order_relaxed) + 1,
+                                   std::memory_order_relaxed);
+            address = it->second.address;
+            return address.core >= 0;
         }
     } else {
-        // Non-blocking check
-        if (!inbox.empty()) {
-            msg = inbox.front();
-            inbox.pop();
-            stats.messages_received++;
-            return true;
+        std::lock_guard<std::mutex> lock(name_mutex);
+        auto it = name_cache.find(name);
+        if (it != name_cache.end()) {
+            // Counted under the lock we already hold; publishing is a plain store
+            stats.name_cache_hits.store(++name_hits, std::memory_order_relaxed);
+            address = it->second.address;
+            return address.core >= 0;
         }
     }
     
-    return false;
+    stats.name_cache_misses++;
+    uint64_t generation;
+    if (!names->lookup(name, address, generation)) return false;
+    
+    cache_name(name, address, generation);
+    return true;
 }
 
-void CoreKernel::broadcast_message(const Message& msg) {
-    for (int i = 0; i < NUM_CORES; i++) {
-        if (i != core_id) {
-            Message broadcast_msg = msg;
-            broadcast_msg.dest_core = i;
-            send_message(broadcast_msg);
-        }
+int CoreKernel::join_names_topic() {
+    int topic = names_topic.load();
+    if (topic >= 0 || !topics) return topic;
+    
+    topic = subscribe("sys.names", [this](const Message& msg) { handle_name_update(msg); });
+    names_topic.store(topic);
+    return topic;
+}
+
+void CoreKernel::cache_name(const std::string& name, ServiceAddress address,
+                            uint64_t generation) {
+    std::lock_guard<std::mutex> lock(name_mutex);
+    
+    // An announcement may overtake the lookup it supersedes; keep the newer
+    auto it = name_cache.find(name);
+    if (it != name_cache.end() && it->second.generation >= generation) return;
+    
+    if (it != name_cache.end()) stats.name_updates++;
+    name_cache[name] = {address, generation};
+    name_epoch.store(name_epoch.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void CoreKernel::announce_names(const std::vector<NameService::Change>& changes) {
+    int topic = names_topic.load();
+    if (topic < 0 && topics) topic = topics->lookup("sys.names");
+    
+    for (const auto& change : changes) {
+        Message msg;
+        snprintf(msg.data, MAX_MESSAGE_SIZE, "%llu %d %d %s",
+                 static_cast<unsigned long long>(change.generation),
+                 change.address.core, change.address.port, change.name.c_str());
+        stage_publish(topic, msg);
+    }
+}
+
+void CoreKernel::handle_name_update(const Message& msg) {
+    unsigned long long generation;
+    ServiceAddress address;
+    int name_at = 0;
+    if (sscanf(msg.data, "%llu %d %d %n", &generation, &address.core, &address.port,
+               &name_at) != 3 || name_at == 0) {
+        return;
     }
+    cache_name(msg.data + name_at, address, generation);
 }
 
 // ============================================================================
 // PROCESS MANAGEMENT
 // ============================================================================
 
+static std::atomic<int> global_pid{0};
+
 int CoreKernel::create_process(int priority) {
     std::lock_guard<std::mutex> lock(process_mutex);
     
-    static std::atomic<int> global_pid{0};
     int pid = global_pid++;
     
-    auto pcb = std::make_shared<ProcessControlBlock>(pid, core_id, priority);
+    auto pcb = new_pcb(pid, priority);
     process_table.push_back(pcb);
+    if (processes) processes->place(pid, core_id);
     
     stats.current_load++;
     
@@ -139,52 +1226,178 @@ int CoreKernel::create_process(int priority) {
     return pid;
 }
 
-bool CoreKernel::migrate_process(int pid, int target_core) {
+void CoreKernel::create_process_batch(const std::vector<int>& priorities,
+                                      std::vector<int>& pids) {
     std::lock_guard<std::mutex> lock(process_mutex);
     
-    // Find process
-    auto it = std::find_if(process_table.begin(), process_table.end(),
-                          [pid](const auto& pcb) { return pcb->pid == pid; });
+    // One lock acquisition and one PID reservation for the whole batch
+    int first_pid = global_pid.fetch_add(static_cast<int>(priorities.size()));
     
-    if (it == process_table.end()) {
-        return false;
+    pids.clear();
+    for (size_t i = 0; i < priorities.size(); i++) {
+        int pid = first_pid + static_cast<int>(i);
+        process_table.push_back(
+            new_pcb(pid, priorities[i]));
+        if (processes) processes->place(pid, core_id);
+        pids.push_back(pid);
     }
     
-    // Create migration message
+    stats.current_load += static_cast<int>(priorities.size());
+    
+    std::cout << "[Core " << core_id << "] Created " << priorities.size()
+              << " processes (pids " << first_pid << "-" << first_pid + priorities.size() - 1
+              << ")" << std::endl;
+}
+
+std::shared_ptr<ProcessControlBlock> CoreKernel::new_pcb(int pid, int priority) {
+    // PCB and its control block come from this core's huge-page slab
+    return std::allocate_shared<ProcessControlBlock>(
+        ArenaAllocator<ProcessControlBlock>(arena), pid, core_id, priority);
+}
+
+bool CoreKernel::migrate_process(int pid, int target_core) {
     Message msg;
-    msg.source_core = core_id;
-    msg.dest_core = target_core;
-    msg.type = MSG_PROCESS_MIGRATE;
-    msg.process_id = pid;
+    {
+        std::lock_guard<std::mutex> lock(process_mutex);
+        
+        // Find process
+        auto pcb = find_process(pid);
+        if (!pcb || pcb->migrating) {
+            return false;
+        }
+        
+        // Create migration message
+        msg.source_core = core_id;
+        msg.dest_core = target_core;
+        msg.type = MSG_PROCESS_MIGRATE;
+        msg.process_id = pid;
+        msg.urgent = true;      // The process is off every run queue until it lands
+        
+        // Copy process data to message
+        snprintf(msg.data, MAX_MESSAGE_SIZE, "priority=%d receiver=%d",
+                 pcb->priority, pcb->has_receiver ? 1 : 0);
+        
+        // Held here, off the run queue, until the destination takes it
+        pcb->migrating = true;
+    }
     
-    // Copy process data to message
-    snprintf(msg.data, MAX_MESSAGE_SIZE, "priority=%d", (*it)->priority);
+    // Sent now rather than staged, outside our locks so the destination's
+    // do not nest under them, and so a refusal can leave the process here
+    if (!send_message(msg)) {
+        std::lock_guard<std::mutex> lock(process_mutex);
+        auto pcb = find_process(pid);
+        if (pcb) pcb->migrating = false;
+        stats.migrations_refused++;
+        
+        std::cout << "[Core " << core_id << "] Core " << target_core
+                  << " refused process " << pid << "; it stays here" << std::endl;
+        return false;
+    }
     
-    send_message(msg);
+    // The process stays here, off the run queue, and keeps taking mail
+    // until the destination acknowledges; handle_process_migrate_ack()
+    // hands over whatever arrived in the meantime
+    return true;
+}
+
+void CoreKernel::handle_process_migrate_ack(const Message& msg) {
+    hand_off_process(msg.process_id, msg.source_core);
+}
+
+void CoreKernel::hand_off_process(int pid, int target_core) {
+    // The destination already owns the directory entry. Mail that got here
+    // first follows the PCB; repeat until none is left.
+    while (true) {
+        std::vector<Message> mail;
+        {
+            std::lock_guard<std::mutex> lock(process_mutex);
+            
+            auto it = std::find_if(process_table.begin(), process_table.end(),
+                                  [pid](const auto& pcb) { return pcb->pid == pid; });
+            
+            if (it == process_table.end()) {
+                // Terminated while the offer was out; finish the job where it went
+                Message end;
+                end.source_core = core_id;
+                end.dest_core = target_core;
+                end.type = MSG_PROCESS_TERMINATE;
+                end.process_id = pid;
+                end.urgent = true;
+                stage_message(end);
+                break;
+            }
+            
+            ProcessControlBlock& pcb = **it;
+            std::lock_guard<std::mutex> mail_lock(pcb.mailbox_mutex);
+            if (pcb.mailbox.empty()) {
+                // Blocked receivers here give up
+                pcb.departed = true;
+                signal_mail(pcb);
+                
+                // Remove from local table
+                process_table.erase(it);
+                stats.current_load--;
+                break;
+            }
+            mail.assign(pcb.mailbox.begin(), pcb.mailbox.end());
+            pcb.mailbox.clear();
+        }
+        
+        // On the urgent path, which no per-source quota holds up; send
+        // times put it ahead of newer mail at the destination
+        size_t sent = 0;
+        for (; sent < mail.size(); sent++) {
+            Message& m = mail[sent];
+            m.source_core = core_id;
+            m.dest_core = target_core;
+            m.urgent = true;
+            if (!send_message(m)) break;
+        }
+        stats.mail_forwarded += sent;
+        if (sent == mail.size()) continue;
+        
+        // The destination's inbox is full: keep the rest and the PCB here
+        // and try again once it has drained a little
+        {
+            std::lock_guard<std::mutex> lock(process_mutex);
+            auto pcb = find_process(pid);
+            if (pcb) {
+                std::lock_guard<std::mutex> mail_lock(pcb->mailbox_mutex);
+                for (size_t i = sent; i < mail.size(); i++) enqueue_mail(*pcb, mail[i]);
+            } else {
+                stats.mail_dropped += mail.size() - sent;
+            }
+        }
+        set_timer(std::chrono::microseconds(MIGRATION_RETRY_US),
+                  [this, pid, target_core]() { hand_off_process(pid, target_core); });
+        return;
+    }
     
-    // Remove from local table
-    process_table.erase(it);
-    stats.current_load--;
+    flush_outbox();
     
     std::cout << "[Core " << core_id << "] Migrated process " << pid 
               << " to Core " << target_core << std::endl;
-    
-    return true;
 }
 
 void CoreKernel::terminate_process(int pid) {
-    std::lock_guard<std::mutex> lock(process_mutex);
-    
-    auto it = std::find_if(process_table.begin(), process_table.end(),
-                          [pid](const auto& pcb) { return pcb->pid == pid; });
-    
-    if (it != process_table.end()) {
+    {
+        std::lock_guard<std::mutex> lock(process_mutex);
+        
+        auto it = std::find_if(process_table.begin(), process_table.end(),
+                              [pid](const auto& pcb) { return pcb->pid == pid; });
+        
+        if (it == process_table.end()) return;
+        
         (*it)->state = PROCESS_TERMINATED;
+        release_process(**it);
         process_table.erase(it);
         stats.current_load--;
         
         std::cout << "[Core " << core_id << "] Terminated process " << pid << std::endl;
     }
+    
+    // Name removals staged by the release
+    flush_outbox();
 }
 
 // ============================================================================
@@ -192,25 +1405,139 @@ void CoreKernel::terminate_process(int pid) {
 // ============================================================================
 
 void CoreKernel::worker_loop() {
+    worker_id.store(std::this_thread::get_id(), std::memory_order_relaxed);
     std::cout << "[Core " << core_id << "] Worker thread started" << std::endl;
     
+    // Park on the inbox through a WaitSet; without one, fall back to inbox_cv
+    worker_waits = std::make_unique<WaitSet>();
+    if (worker_waits->add_inbox(this) < 0) worker_waits.reset();
+    
+    auto next_tick = std::chrono::steady_clock::now();
+    
+    bool exhausted_since_tick = false;
+    
     while (running) {
-        // Process incoming messages
-        Message msg;
-        while (receive_message(msg, 0)) {
-            process_message(msg);
+        // Process incoming messages, but never so many that a storm keeps
+        // the processes below from running
+        bool exhausted = handle_messages();
+        exhausted_since_tick |= exhausted;
+        
+        auto now = std::chrono::steady_clock::now();
+        if (now >= next_tick) {
+            adapt_budget(now - next_tick, exhausted_since_tick);
+            exhausted_since_tick = false;
+            
+            epoch++;
+            
+            // Execute processes on this core; messages handled mid-pass are
+            // already in message_time_us
+            auto preempted = execute_processes();
+            flush_outbox();
+            
+            reclaim_idle_channels();
+            adapt_channel_capacity();
+            send_idle_heartbeats();
+            
+            auto done = std::chrono::steady_clock::now();
+            stats.process_time_us += std::chrono::duration_cast<std::chrono::microseconds>(
+                done - now - preempted).count();
+            next_tick = done + std::chrono::milliseconds(WORKER_TICK_MS);
+        }
+        
+        // Publish coalesced sends whose delay budget has run out
+        publish_due(false);
+        fire_timers();
+        
+        // More is already queued; go straight back for it
+        if (exhausted) continue;
+        
+        // Park until the next tick or a new arrival. Messages the interconnect
+        // model is still holding back count as pending but cannot be popped,
+        // so only arrivals beyond those wake us early.
+        // Recheck held-back messages every millisecond so they are not
+        // delayed by a whole tick past their modeled arrival.
+        int backlog = interconnect ? pending_messages.load() : 0;
+        auto deadline = next_tick;
+        if (backlog > 0) {
+            deadline = std::min(deadline, now + std::chrono::milliseconds(1));
         }
         
-        // Execute processes on this core
-        execute_processes();
+        // Also wake for the oldest held send; a sender that moves this
+        // deadline earlier kicks us so we come back and recompute it
+        kicked.store(false);
+        int64_t due_ns = coalesce_next_due_ns.load();
+        if (due_ns != INT64_MAX) {
+            deadline = std::min(deadline, std::chrono::steady_clock::time_point(
+                std::chrono::nanoseconds(due_ns)));
+        }
         
-        // CRITICAL: Increased sleep to reduce CPU usage and prevent busy-waiting
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        // And for the next timer; set_timer kicks us if it moves earlier
+        {
+            std::lock_guard<std::mutex> lock(timer_mutex);
+            deadline = std::min(deadline, timers.next_deadline());
+        }
+        park_until(deadline, backlog);
     }
+    
+    // Nothing held back may outlive the worker
+    publish_due(true);
 
     std::cout << "[Core " << core_id << "] Worker thread stopped" << std::endl;
 }
 
+bool CoreKernel::handle_messages() {
+    // This pass drains the bootstrap channel first, urgent messages included
+    preempt_requested.store(false, std::memory_order_relaxed);
+    
+    auto start = std::chrono::steady_clock::now();
+    auto time_limit = start + std::chrono::microseconds(message_time_budget_us.load());
+    int budget = message_budget.load(std::memory_order_relaxed);
+    bool exhausted = false;
+    
+    Message msg;
+    for (int handled = 0; ; handled++) {
+        // Reading the clock per message would cost more than most handlers
+        if (handled == budget ||
+            (handled % 16 == 15 && std::chrono::steady_clock::now() >= time_limit)) {
+            exhausted = pending_messages > 0 || !local_queue.empty();
+            break;
+        }
+        if (!receive_message(msg, 0)) break;
+        process_message(msg);
+    }
+    
+    // Replies staged by the handlers go out together, once per pass
+    flush_outbox();
+    
+    if (exhausted) stats.budget_exhaustions++;
+    stats.message_time_us += std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    return exhausted;
+}
+
+void CoreKernel::adapt_budget(std::chrono::steady_clock::duration tick_lateness, bool exhausted) {
+    if (!adaptive_budget) return;
+    
+    // Halve when message handling made the processes late; double when the
+    // budget cut messages short but the processes were on time anyway
+    int budget = message_budget.load(std::memory_order_relaxed);
+    if (tick_lateness > std::chrono::microseconds(TICK_SLACK_US) && get_load() > 0) {
+        budget = std::max(MESSAGE_BUDGET_MIN, budget / 2);
+    } else if (exhausted) {
+        budget = std::min(MESSAGE_BUDGET_MAX, budget * 2);
+    }
+    message_budget.store(budget, std::memory_order_relaxed);
+    stats.message_budget = budget;
+}
+
+void CoreKernel::set_message_budget(int messages, int time_us, bool adaptive) {
+    messages = std::max(1, messages);
+    message_budget.store(messages, std::memory_order_relaxed);
+    message_time_budget_us.store(std::max(1, time_us));
+    adaptive_budget.store(adaptive);
+    stats.message_budget = messages;
+}
+
 void CoreKernel::process_message(const Message& msg) {
     switch (msg.type) {
         case MSG_PROCESS_CREATE:
@@ -221,6 +1548,10 @@ void CoreKernel::process_message(const Message& msg) {
             handle_process_migrate(msg);
             break;
 
+        case MSG_PROCESS_MIGRATE_ACK:
+            handle_process_migrate_ack(msg);
+            break;
+
         case MSG_PROCESS_TERMINATE:
             handle_process_terminate(msg);
             break;
@@ -229,6 +1560,22 @@ void CoreKernel::process_message(const Message& msg) {
             // Heartbeat received - core is alive
             break;
 
+        case MSG_CHANNEL_OPEN:
+            handle_channel_open(msg);
+            break;
+
+        case MSG_CHANNEL_ACK:
+            handle_channel_ack(msg);
+            break;
+
+        case MSG_TOPIC_UPDATE:
+            handle_topic_update(msg);
+            break;
+
+        case MSG_PROCESS_MAIL:
+            deliver_mail(msg);
+            break;
+
         case MSG_SHUTDOWN:
             running = false;
             break;
@@ -246,37 +1593,239 @@ void CoreKernel::handle_process_create(const Message& msg) {
 }
 
 void CoreKernel::handle_process_migrate(const Message& msg) {
-    std::lock_guard<std::mutex> lock(process_mutex);
-
-    int priority = 5;
-    sscanf(msg.data, "priority=%d", &priority);
+    {
+        std::lock_guard<std::mutex> lock(process_mutex);
+        
+        int priority = 5;
+        int receiver = 0;
+        sscanf(msg.data, "priority=%d receiver=%d", &priority, &receiver);
 
-    // Receive migrated process
-    auto pcb = std::make_shared<ProcessControlBlock>(msg.process_id, core_id, priority);
-    process_table.push_back(pcb);
-    stats.current_load++;
+        // Receive migrated process; a thread-driven one stays thread-driven
+        auto pcb = new_pcb(msg.process_id, priority);
+        pcb->has_receiver = receiver != 0;
+        process_table.push_back(pcb);
+        stats.current_load++;
+        
+        // New mail comes here from now on, straight into the installed PCB.
+        // The old core may have released it meanwhile; its terminate follows.
+        if (processes) processes->move(msg.process_id, msg.source_core, core_id);
+        
+        // Names it serves now resolve here; the pass's flush tells the caches
+        if (names) announce_names(names->rehome(msg.process_id, core_id));
 
-    std::cout << "[Core " << core_id << "] Received migrated process "
-              << msg.process_id << std::endl;
+        std::cout << "[Core " << core_id << "] Received migrated process "
+                  << msg.process_id << std::endl;
+    }
+    
+    // The old core still holds any mail that beat the switch
+    Message ack;
+    ack.source_core = core_id;
+    ack.dest_core = msg.source_core;
+    ack.type = MSG_PROCESS_MIGRATE_ACK;
+    ack.process_id = msg.process_id;
+    ack.urgent = true;
+    stage_message(ack);
 }
 
 void CoreKernel::handle_process_terminate(const Message& msg) {
     terminate_process(msg.process_id);
 }
 
-void CoreKernel::execute_processes() {
-    std::lock_guard<std::mutex> lock(process_mutex);
+// ============================================================================
+// CHANNEL MANAGEMENT - Lazy setup and idle reclamation
+// ============================================================================
+
+void CoreKernel::handle_channel_open(const Message& msg) {
+    int source = msg.source_core;
+    if (source < 0 || source >= NUM_CORES) return;
+    
+    std::shared_ptr<Channel> created;
+    {
+        std::lock_guard<std::mutex> lock(rx_mutex);
+        if (!rx_channels[source]) {
+            rx_channels[source] = std::make_shared<Channel>(source, core_id, arena);
+            created = rx_channels[source];
+            rx_quiet_windows[source] = 0;
+            rx_growth_held[source] = false;
+        }
+    }
+    
+    if (created) {
+        stats.open_channels++;
+        stats.channel_bytes += created->memory_bytes();
+        stats.channels_opened++;
+        
+        std::cout << "[Core " << core_id << "] Opened channel from Core "
+                  << source << std::endl;
+    }
+    
+    // Duplicate OPENs (sender retried) are simply acknowledged again
+    Message ack;
+    ack.source_core = core_id;
+    ack.dest_core = source;
+    ack.type = MSG_CHANNEL_ACK;
+    stage_message(ack);
+}
+
+void CoreKernel::handle_channel_ack(const Message& msg) {
+    int dest = msg.source_core;
+    if (dest < 0 || dest >= NUM_CORES || !all_cores) return;
+    
+    std::shared_ptr<Channel> channel = (*all_cores)[dest]->find_rx_channel(core_id);
+    
+    std::lock_guard<std::mutex> lock(tx_mutex);
+    tx_open_sent_ms[dest] = 0;
+    if (channel) {
+        tx_channels[dest] = channel;
+    }
+}
+
+std::shared_ptr<Channel> CoreKernel::find_rx_channel(int source) {
+    std::lock_guard<std::mutex> lock(rx_mutex);
+    return rx_channels[source];
+}
+
+void CoreKernel::reclaim_idle_channels() {
+    int64_t now = steady_now_ms();
+    std::vector<std::shared_ptr<Channel>> reclaimed;
+    
+    {
+        std::lock_guard<std::mutex> lock(rx_mutex);
+        for (auto& channel : rx_channels) {
+            if (channel && channel->is_idle(now, CHANNEL_IDLE_TIMEOUT_MS) &&
+                channel->try_close()) {
+                reclaimed.push_back(channel);
+                channel.reset();
+            }
+        }
+    }
+    
+    for (const auto& channel : reclaimed) {
+        stats.open_channels--;
+        stats.channel_bytes -= channel->memory_bytes();
+        stats.channels_reclaimed++;
+        
+        std::cout << "[Core " << core_id << "] Reclaimed idle channel from Core "
+                  << channel->get_source_core() << std::endl;
+    }
+}
+
+void CoreKernel::adapt_channel_capacity() {
+    int64_t now = steady_now_ms();
+    if (now - last_resize_ms < CHANNEL_RESIZE_INTERVAL_MS) return;
+    last_resize_ms = now;
+    
+    std::vector<std::shared_ptr<Channel>> open;
+    {
+        std::lock_guard<std::mutex> lock(rx_mutex);
+        open = rx_channels;
+    }
+    
+    for (int source = 0; source < NUM_CORES; source++) {
+        Channel* channel = open[source].get();
+        if (!channel) continue;
+        
+        uint64_t refused;
+        size_t peak, trough;
+        channel->sample_pressure(refused, peak, trough);
+        size_t slots = channel->get_slot_count();
+        size_t old_bytes = channel->memory_bytes();
+        
+        // Pressure is the sender being pushed back or the ring running nearly
+        // full. If the ring also never drained below half, we are the
+        // bottleneck and a bigger ring would only queue longer.
+        bool pressured = refused > 0 || peak * 10 >= slots * 9;
+        bool backlogged = trough * 2 >= slots;
+        bool quiet = peak * 4 < slots;
+        rx_quiet_windows[source] = quiet ? rx_quiet_windows[source] + 1 : 0;
+        if (!pressured) rx_growth_held[source] = false;
+        
+        if (pressured && backlogged) {
+            if (!rx_growth_held[source]) {
+                std::cout << "[Core " << core_id << "] Channel from Core " << source
+                          << " stays at " << old_bytes / 1024
+                          << " KiB: this core is the bottleneck, not the ring" << std::endl;
+            }
+            rx_growth_held[source] = true;
+        } else if (pressured) {
+            size_t target = std::min(slots * 2, channel_slots(CHANNEL_CAPACITY_MAX));
+            if (target <= slots) continue;
+            
+            if (channel->resize(target)) {
+                stats.channel_grows++;
+                stats.channel_bytes += channel->memory_bytes() - old_bytes;
+                rx_growth_held[source] = false;
+                std::cout << "[Core " << core_id << "] Grew channel from Core " << source
+                          << " to " << channel->memory_bytes() / 1024 << " KiB ("
+                          << refused << " sends refused)" << std::endl;
+            } else {
+                // Count every denial but log only the first of an episode
+                stats.channel_grows_denied++;
+                if (!rx_growth_held[source]) {
+                    std::cout << "[Core " << core_id << "] Channel from Core " << source
+                              << " under pressure, growth denied by memory budget ("
+                              << channel_memory_in_use() / 1024 << "/"
+                              << channel_memory_budget() / 1024 << " KiB)" << std::endl;
+                }
+                rx_growth_held[source] = true;
+            }
+        } else if (rx_quiet_windows[source] >= CHANNEL_SHRINK_WINDOWS) {
+            size_t target = std::max(slots / 2, channel_slots(CHANNEL_CAPACITY_MIN));
+            rx_quiet_windows[source] = 0;
+            if (target >= slots || !channel->resize(target)) continue;
+            
+            stats.channel_shrinks++;
+            stats.channel_bytes -= old_bytes - channel->memory_bytes();
+            std::cout << "[Core " << core_id << "] Shrank quiet channel from Core " << source
+                      << " to " << channel->memory_bytes() / 1024 << " KiB" << std::endl;
+        }
+    }
+}
+
+std::chrono::steady_clock::duration CoreKernel::execute_processes() {
+    std::unique_lock<std::mutex> lock(process_mutex);
 
     // VERY AGGRESSIVE TERMINATION for fast demos
     static std::random_device rd;
     static std::mt19937 gen(rd());
     static std::uniform_int_distribution<> dis(1, 100);
 
-    for (auto& pcb : process_table) {
+    uint32_t pass = epoch.load();
+    std::chrono::steady_clock::duration preempted{0};
+    int slice_us = process_slice_us.load();
+
+    for (size_t i = 0; i < process_table.size(); i++) {
+        // Safe point between processes: if an urgent message arrived, drop
+        // the table lock so its handler can run now rather than after the pass
+        if (preempt_requested.load(std::memory_order_acquire)) {
+            lock.unlock();
+            stats.preemptions++;
+            auto handled_from = std::chrono::steady_clock::now();
+            handle_messages();
+            preempted += std::chrono::steady_clock::now() - handled_from;
+            lock.lock();
+            
+            // The handlers may have reshaped the table; rescan it, skipping
+            // whatever already ran this pass
+            if (!running || process_table.empty()) break;
+            i = 0;
+        }
+        
+        auto& pcb = process_table[i];
+        
+        // Whoever calls receive_mail for it is running it for real, and a
+        // process on offer to another core runs nowhere until it lands
+        if (pcb->has_receiver || pcb->migrating || pcb->last_run_epoch == pass) continue;
+        pcb->last_run_epoch = pass;
+        
         if (pcb->state == PROCESS_READY || pcb->state == PROCESS_RUNNING) {
             pcb->state = PROCESS_RUNNING;
 
             // Simulate process execution
+            if (slice_us > 0) {
+                auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(slice_us);
+                while (std::chrono::steady_clock::now() < until) {}
+            }
             pcb->cpu_time += std::chrono::milliseconds(50);
             stats.processes_executed++;
             stats.context_switches++;
@@ -302,6 +1851,9 @@ void CoreKernel::execute_processes() {
     }
 
     // Remove terminated processes
+    for (auto& pcb : process_table) {
+        if (pcb->state == PROCESS_TERMINATED) release_process(*pcb);
+    }
     auto old_size = process_table.size();
     process_table.erase(
         std::remove_if(process_table.begin(), process_table.end(),
@@ -317,4 +1869,5 @@ void CoreKernel::execute_processes() {
         std::cout << "[Core " << core_id << "] Terminated " << terminated_count
                   << " processes (load now: " << stats.current_load << ")" << std::endl;
     }
+    return preempted;
 }
\ No newline at end of file
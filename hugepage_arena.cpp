@@ -0,0 +1,128 @@
+#include "multikernel.h"
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <sys/mman.h>
+
+// ============================================================================
+// HUGE PAGE POLICY
+// ============================================================================
+
+static std::atomic<bool>& hugepage_policy() {
+    static std::atomic<bool> enabled{[] {
+        const char* env = std::getenv("MULTIKERNEL_HUGEPAGES");
+        return !(env && env[0] == '0');
+    }()};
+    return enabled;
+}
+
+void set_hugepages_enabled(bool enabled) {
+    hugepage_policy().store(enabled);
+}
+
+bool hugepages_enabled() {
+    return hugepage_policy().load();
+}
+
+const char* page_backing_name(PageBacking backing) {
+    switch (backing) {
+        case BACKING_HUGETLB: return "hugetlb (2 MiB)";
+        case BACKING_THP:     return "transparent huge pages";
+        case BACKING_NORMAL:  return "4 KiB pages";
+        default:              return "none";
+    }
+}
+
+// ============================================================================
+// HUGE PAGE ARENA IMPLEMENTATION
+// ============================================================================
+
+static const size_t ARENA_ALIGNMENT = 64;   // Keep blocks on their own cache lines
+
+static size_t round_up(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+HugePageArena::~HugePageArena() {
+    for (const auto& region : regions) {
+        munmap(region.base, region.size);
+    }
+}
+
+bool HugePageArena::grow(size_t min_bytes) {
+    size_t size = round_up(std::max(min_bytes, HUGE_PAGE_SIZE), HUGE_PAGE_SIZE);
+    void* base = MAP_FAILED;
+    PageBacking got = BACKING_NORMAL;
+
+    if (hugepages_enabled()) {
+        // Explicit huge pages only work if the administrator reserved some
+        base = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        got = BACKING_HUGETLB;
+
+        if (base == MAP_FAILED) {
+            // Over-map so the region can start on a 2 MiB boundary, which THP needs
+            size_t padded = size + HUGE_PAGE_SIZE;
+            char* raw = static_cast<char*>(mmap(nullptr, padded, PROT_READ | PROT_WRITE,
+                                                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+            if (raw != MAP_FAILED) {
+                char* aligned = reinterpret_cast<char*>(
+                    round_up(reinterpret_cast<uintptr_t>(raw), HUGE_PAGE_SIZE));
+                if (aligned > raw) munmap(raw, aligned - raw);
+                size_t tail = (raw + padded) - (aligned + size);
+                if (tail > 0) munmap(aligned + size, tail);
+
+                base = aligned;
+                got = madvise(base, size, MADV_HUGEPAGE) == 0 ? BACKING_THP : BACKING_NORMAL;
+            }
+        }
+    }
+
+    if (base == MAP_FAILED) {
+        base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        got = BACKING_NORMAL;
+    }
+
+    if (base == MAP_FAILED) {
+        return false;
+    }
+
+    regions.push_back({base, size});
+    bump = static_cast<char*>(base);
+    remaining = size;
+    bytes_mapped += size;
+
+    // Report the weakest backing in use
+    int current = backing.load();
+    if (current == BACKING_NONE || got > current) {
+        backing.store(got);
+    }
+    return true;
+}
+
+void* HugePageArena::allocate(size_t bytes) {
+    size_t size = round_up(std::max<size_t>(bytes, 1), ARENA_ALIGNMENT);
+    std::lock_guard<std::mutex> lock(arena_mutex);
+
+    auto it = free_lists.find(size);
+    if (it != free_lists.end() && !it->second.empty()) {
+        void* ptr = it->second.back();
+        it->second.pop_back();
+        return ptr;
+    }
+
+    if (size > remaining && !grow(size)) {
+        throw std::bad_alloc();
+    }
+
+    void* ptr = bump;
+    bump += size;
+    remaining -= size;
+    return ptr;
+}
+
+void HugePageArena::deallocate(void* ptr, size_t bytes) {
+    size_t size = round_up(std::max<size_t>(bytes, 1), ARENA_ALIGNMENT);
+    std::lock_guard<std::mutex> lock(arena_mutex);
+    free_lists[size].push_back(ptr);
+}
@@ -0,0 +1,102 @@
+#include "multikernel.h"
+#include <algorithm>
+#include <sstream>
+
+// ============================================================================
+// TOPOLOGY DESCRIPTION
+// ============================================================================
+
+bool InterconnectTopology::parse(const std::string& spec, InterconnectTopology& out) {
+    InterconnectTopology topo;
+    std::stringstream ss(spec);
+    std::string field;
+
+    // First field is the shape, "<sockets>x<cores per socket>"
+    if (!std::getline(ss, field, ',') ||
+        sscanf(field.c_str(), "%dx%d", &topo.sockets, &topo.cores_per_socket) != 2 ||
+        topo.sockets <= 0 || topo.cores_per_socket <= 0) {
+        return false;
+    }
+
+    while (std::getline(ss, field, ',')) {
+        long long latency;
+        double value;
+
+        if (field == "virtual") {
+            topo.virtual_time = true;
+        } else if (sscanf(field.c_str(), "local=%lld", &latency) == 1) {
+            topo.local_latency_ns = latency;
+        } else if (sscanf(field.c_str(), "remote=%lf", &value) == 1) {
+            topo.remote_penalty = value;
+        } else if (sscanf(field.c_str(), "bw=%lf", &value) == 1 && value > 0) {
+            topo.bandwidth_bytes_per_ns = value;
+        } else {
+            return false;
+        }
+    }
+
+    out = topo;
+    return true;
+}
+
+// ============================================================================
+// INTERCONNECT MODEL IMPLEMENTATION
+// ============================================================================
+
+InterconnectModel::InterconnectModel(const InterconnectTopology& topo)
+    : topology(topo) {
+    for (int i = 0; i < topology.sockets * topology.sockets; i++) {
+        links.push_back(std::make_unique<Link>());
+    }
+}
+
+int InterconnectModel::socket_of(int core) const {
+    return std::min(core / topology.cores_per_socket, topology.sockets - 1);
+}
+
+std::chrono::steady_clock::time_point InterconnectModel::schedule(
+        int source_core, int dest_core, size_t bytes,
+        std::chrono::steady_clock::time_point now) {
+    int src = socket_of(source_core);
+    int dst = socket_of(dest_core);
+    bool remote = src != dst;
+
+    int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        now.time_since_epoch()).count();
+    int64_t transfer_ns = static_cast<int64_t>(bytes / topology.bandwidth_bytes_per_ns);
+    int64_t latency_ns = remote
+        ? static_cast<int64_t>(topology.local_latency_ns * topology.remote_penalty)
+        : topology.local_latency_ns;
+
+    // Transfers on the same link serialize: wait for the link, then occupy it
+    int64_t start_ns;
+    {
+        Link& link = *links[src * topology.sockets + dst];
+        std::lock_guard<std::mutex> lock(link.link_mutex);
+        start_ns = std::max(now_ns, link.busy_until_ns);
+        link.busy_until_ns = start_ns + transfer_ns;
+    }
+
+    int64_t deliver_ns = start_ns + transfer_ns + latency_ns;
+
+    messages_modeled++;
+    if (remote) remote_messages++;
+    total_latency_ns += static_cast<uint64_t>(deliver_ns - now_ns);
+    contention_ns += static_cast<uint64_t>(start_ns - now_ns);
+
+    return std::chrono::steady_clock::time_point(std::chrono::nanoseconds(deliver_ns));
+}
+
+void InterconnectModel::print_statistics() const {
+    uint64_t count = messages_modeled.load();
+
+    std::cout << "\n--- Interconnect Model ("
+              << topology.sockets << " sockets x " << topology.cores_per_socket << " cores, "
+              << (topology.virtual_time ? "virtual" : "real") << " time) ---" << std::endl;
+    std::cout << "  Messages Modeled:        " << count
+              << " (" << remote_messages << " cross-socket)" << std::endl;
+    if (count > 0) {
+        std::cout << "  Avg Modeled Latency:     " << total_latency_ns / count << " ns" << std::endl;
+        std::cout << "  Avg Contention Delay:    " << contention_ns / count << " ns" << std::endl;
+    }
+}
@@ -2,6 +2,7 @@
 #include <iostream>
 #include <thread>
 #include <chrono>
+#include <cstdlib>
 
 using namespace std::chrono_literals;
 
@@ -132,6 +133,17 @@ int main() {
 
     // Create and start the multikernel system
     MultikernelSystem system;
+    
+    // Optionally simulate a NUMA interconnect, e.g. MULTIKERNEL_TOPOLOGY=2x4,remote=3
+    if (const char* spec = std::getenv("MULTIKERNEL_TOPOLOGY")) {
+        InterconnectTopology topology;
+        if (InterconnectTopology::parse(spec, topology)) {
+            system.set_interconnect_model(topology);
+        } else {
+            std::cerr << "Ignoring invalid MULTIKERNEL_TOPOLOGY: " << spec << std::endl;
+        }
+    }
+    
     system.start();
 
     try {
@@ -152,6 +164,7 @@ int main() {
 
         // Final statistics
         system.print_statistics();
+        system.print_channel_report();
 
     } catch (const std::exception& e) {
         std::cerr << "\nError: " << e.what() << std::endl;
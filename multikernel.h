@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <queue>
+#include <deque>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -11,9 +12,14 @@
 #include <memory>
 #include <chrono>
 #include <map>
+#include <unordered_map>
 #include <functional>
 #include <cstring>
 #include <cstdint>
+#include <string>
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
 
 // ============================================================================
 // SYSTEM CONFIGURATION
@@ -22,6 +28,39 @@ const int NUM_CORES = 8;                    // Number of cores in the system
 const int MAX_MESSAGE_SIZE = 512;           // Maximum message payload size
 const int MESSAGE_QUEUE_SIZE = 100;         // Max messages per core queue
 const int MAX_PROCESSES = 64;               // Maximum processes system-wide
+const size_t CACHE_LINE_SIZE = 64;          // Alignment unit for contended data
+const int NUM_NODES = 2;                    // NUMA nodes (coordination domains)
+const int CORES_PER_NODE = NUM_CORES / NUM_NODES;
+const int NODE_SATURATION_LOAD = MAX_PROCESSES / NUM_CORES;  // Per-core fair share
+const int MAX_COMBINER_CLIENTS = 64;        // Publication slots in the combining front end
+const int SUBMISSION_RING_SIZE = 256;       // Entries per client ring (power of two)
+const int INGEST_BATCH = 32;                // Max entries drained per client per pass
+const int CLUSTER_BATCH = 32;               // Messages per cross-node frame
+const int CLUSTER_FLUSH_INTERVAL_US = 500;  // Max time a message waits for a batch
+const int CHANNEL_CAPACITY = 100;           // Max messages per core-to-core channel
+const int CHANNEL_IDLE_TIMEOUT_MS = 2000;   // Reclaim channels idle this long
+const int WORKER_TICK_MS = 50;              // Scheduling tick of each core's worker
+const int MESSAGE_BUDGET_INITIAL = 64;      // Messages handled per worker pass, to start
+const int MESSAGE_BUDGET_MIN = 8;           // Adaptive budget bounds
+const int MESSAGE_BUDGET_MAX = 1024;
+const int MESSAGE_TIME_BUDGET_US = 2000;    // Hard cap on one pass of message handling
+const int TICK_SLACK_US = 500;              // Tick lateness that makes the budget shrink
+const int COALESCE_MAX_BATCH = 64;          // Upper bound on one coalesced unit
+const int HEARTBEAT_INTERVAL_MS = 250;      // How often links are checked for liveness
+const int HEARTBEAT_IDLE_MS = 250;          // Only links quiet this long get a heartbeat
+const int BOOTSTRAP_SOURCE_QUOTA = MESSAGE_QUEUE_SIZE / 4;  // Data messages one source may park in an inbox
+const int MAX_TOPICS = 64;                  // Named publish/subscribe topics system-wide
+const size_t CHANNEL_SLOT_SIZE = 64;        // Ring granule; a message spans whole slots
+const int CHANNEL_CAPACITY_MIN = CHANNEL_CAPACITY / 4;  // Adaptive ring bounds, in full-size messages
+const int CHANNEL_CAPACITY_MAX = CHANNEL_CAPACITY * 8;
+const int CHANNEL_RESIZE_INTERVAL_MS = 100; // Pressure sampling window
+const int CHANNEL_SHRINK_WINDOWS = 10;      // Quiet windows in a row before shrinking
+const uint64_t CHANNEL_MEMORY_BUDGET = 8ULL << 20;  // Default cap on all rings together
+const int TIMER_WHEEL_TICK_US = 100;        // Resolution of the per-core timer wheel
+const int PROCESS_MAILBOX_CAPACITY = 64;    // Undelivered messages one process may hold
+const int MIGRATION_RETRY_US = 200;         // Pause before re-sending mail a busy new owner refused
+const int PROCESS_DIRECTORY_SHARDS = 16;    // Lock shards of the PID-to-core directory
+const int MAX_SERVICE_NAME = 128;           // Longest name the name service accepts
 
 // ============================================================================
 // MESSAGE TYPES - Inter-core communication protocol
@@ -34,26 +73,84 @@ enum MessageType {
     MSG_RESOURCE_RELEASE,    // Release shared resource
     MSG_SYNC_BARRIER,        // Synchronization barrier
     MSG_HEARTBEAT,           // Core health check
-    MSG_SHUTDOWN             // Shutdown signal
+    MSG_CHANNEL_OPEN,        // Ask receiver to set up a channel (bootstrap)
+    MSG_CHANNEL_ACK,         // Channel ready, sender may switch to it
+    MSG_TOPIC_UPDATE,        // Publication on a topic, sent only to its subscribers
+    MSG_PROCESS_MAIL,        // Mail for process_id, delivered into its mailbox
+    MSG_PROCESS_MIGRATE_ACK, // Migrated process installed, old core may let go
+    MSG_SHUTDOWN,            // Shutdown signal
+    MSG_TYPE_COUNT           // Number of message types, not a message
 };
 
 // ============================================================================
 // MESSAGE STRUCTURE - Core communication packet
 // ============================================================================
+// The payload is the last member, so the header is everything before it and
+// channels copy only the header plus the bytes actually used.
 struct Message {
     int source_core;                    // Sender core ID
     int dest_core;                      // Destination core ID (-1 for broadcast)
     MessageType type;                   // Message type
     int process_id;                     // Related process ID
-    char data[MAX_MESSAGE_SIZE];        // Payload data
+    int topic;                          // MSG_TOPIC_UPDATE: topic id (-1 = none)
+    bool urgent;                        // Preempt the receiver's scheduler pass
+    uint16_t data_len;                  // Payload bytes in use (0 = text, see payload_size)
+    int sender_load;                    // Piggybacked: sender's load when sent (-1 = none)
+    uint32_t sender_epoch;              // Piggybacked: sender's scheduler tick count
     std::chrono::steady_clock::time_point timestamp;  // For latency tracking
+    std::chrono::steady_clock::time_point deliver_at; // Interconnect model: not before this
+    std::chrono::steady_clock::time_point expires_at; // Worthless after this; max() = never
+    char data[MAX_MESSAGE_SIZE];        // Payload data
     
     Message() : source_core(-1), dest_core(-1), type(MSG_HEARTBEAT), 
-                process_id(-1), timestamp(std::chrono::steady_clock::now()) {
-        memset(data, 0, MAX_MESSAGE_SIZE);
+                process_id(-1), topic(-1), urgent(false), data_len(0),
+                sender_load(-1), sender_epoch(0), timestamp(std::chrono::steady_clock::now()),
+                expires_at(std::chrono::steady_clock::time_point::max()) {
+        data[0] = '\0';
+    }
+    
+    // For heartbeats, load reports and hints that are useless once late
+    void set_ttl(std::chrono::microseconds ttl) { expires_at = timestamp + ttl; }
+    bool has_deadline() const { return expires_at != std::chrono::steady_clock::time_point::max(); }
+    bool expired(std::chrono::steady_clock::time_point now) const { return now > expires_at; }
+    
+    // Binary payloads set their length explicitly; text keeps its terminator
+    void set_payload(const void* bytes, size_t len) {
+        data_len = static_cast<uint16_t>(std::min<size_t>(len, MAX_MESSAGE_SIZE));
+        memcpy(data, bytes, data_len);
     }
+    void set_payload(const std::string& text) {
+        set_payload(text.c_str(), text.size() + 1);
+        data[MAX_MESSAGE_SIZE - 1] = '\0';
+    }
+    
+    // Bytes of data[] that travel. Writers that fill data[] directly as a
+    // C string leave data_len at 0 and are measured up to the terminator.
+    size_t payload_size() const {
+        if (data_len > 0) return data_len;
+        size_t text = strnlen(data, MAX_MESSAGE_SIZE);
+        return text == 0 ? 0 : std::min<size_t>(text + 1, MAX_MESSAGE_SIZE);
+    }
+};
+
+static_assert(std::is_trivially_copyable<Message>::value && std::is_standard_layout<Message>::value,
+              "Channels copy messages bytewise, header and payload separately");
+const size_t MESSAGE_HEADER_SIZE = offsetof(Message, data);
+
+// Liveness and load a sender stamps into every message it publishes, so
+// receivers learn about their peers without separate reports
+struct PeerMeta {
+    int load = -1;
+    uint32_t epoch = 0;
 };
 
+// Bytes a message occupies on the wire; the unit of receiver-side fairness
+inline size_t wire_size(const Message& msg) {
+    return MESSAGE_HEADER_SIZE + msg.payload_size();
+}
+
+const size_t DRR_QUANTUM_BYTES = 4 * sizeof(Message);  // Per-source credit per round
+
 // ============================================================================
 // PROCESS CONTROL BLOCK - Per-process metadata
 // ============================================================================
@@ -72,10 +169,23 @@ struct ProcessControlBlock {
     std::chrono::steady_clock::time_point creation_time;
     std::chrono::milliseconds cpu_time; // Total CPU time used
     
+    // Mail addressed to this process. State changes still go under the
+    // owning core's process_mutex, which is taken before mailbox_mutex.
+    std::mutex mailbox_mutex;
+    std::condition_variable mailbox_cv;
+    std::deque<Message> mailbox;
+    bool departed = false;              // Migrated or terminated; receivers stop waiting
+    bool migrating = false;             // Offered to another core, not yet accepted
+    uint32_t last_run_epoch = 0;        // Scheduler pass that last ran it
+    bool has_receiver = false;          // Run by a thread in receive_mail, not simulated
+    int mail_fd = -1;                   // eventfd for WaitSets, created on first watch
+    bool mail_armed = false;            // A WaitSet wants the next arrival signalled
+    
     ProcessControlBlock(int id, int core, int prio = 5) 
         : pid(id), core_id(core), state(PROCESS_READY), 
           priority(prio), creation_time(std::chrono::steady_clock::now()),
           cpu_time(0) {}
+    ~ProcessControlBlock();
 };
 
 // ============================================================================
@@ -88,99 +198,1019 @@ struct CoreStatistics {
     std::atomic<uint64_t> context_switches{0};
     std::atomic<int64_t> avg_message_latency_us{0};
     std::atomic<int> current_load{0};  // Number of active processes
+    std::atomic<uint64_t> message_time_us{0};   // Worker time spent handling messages
+    std::atomic<uint64_t> process_time_us{0};   // Worker time spent running processes
+    std::atomic<uint64_t> budget_exhaustions{0};// Passes cut short with messages left
+    std::atomic<int> message_budget{MESSAGE_BUDGET_INITIAL};  // Current per-pass budget
+    std::atomic<uint64_t> urgent_messages{0};   // Urgent messages handled
+    std::atomic<uint64_t> urgent_latency_us{0}; // Summed send-to-handle latency of those
+    std::atomic<uint64_t> preemptions{0};       // Scheduler passes interrupted for them
+    std::atomic<uint64_t> outbox_staged{0};     // Messages sent through the outbox
+    std::atomic<uint64_t> outbox_refused{0};    // Of those, pushed back by their destination
+    std::atomic<uint64_t> migrations_refused{0};    // Destination would not take the process
+    std::atomic<uint64_t> outbox_flushes{0};    // Outbox flushes that sent anything
+    std::atomic<uint64_t> batched_pushes{0};    // Multi-message channel pushes
+    std::atomic<uint64_t> coalesced_messages{0};// Sends held back for coalescing
+    std::atomic<uint64_t> coalesced_units{0};   // Units those were published in
+    std::atomic<uint64_t> coalesced_refused{0}; // Held sends pushed back when their unit went out
+    std::atomic<uint64_t> heartbeats_sent{0};   // Dedicated heartbeats on idle links
+    std::atomic<uint64_t> peer_updates_piggybacked{0}; // Peer load/epoch taken from regular traffic
+    std::atomic<uint64_t> topic_published{0};   // Publications made by this core
+    std::atomic<uint64_t> topic_fanout{0};      // Copies sent, one per subscriber
+    std::atomic<uint64_t> topic_delivered{0};   // Updates handed to a local handler
+    std::atomic<uint64_t> topic_dropped{0};     // Arrived after we unsubscribed
+    std::atomic<uint64_t> wire_messages{0};     // Messages written into channel rings
+    std::atomic<uint64_t> wire_bytes{0};        // Header plus used payload, as written
+    std::atomic<uint64_t> channel_grows{0};     // Inbound rings enlarged under pressure
+    std::atomic<uint64_t> channel_shrinks{0};   // Inbound rings shrunk while quiet
+    std::atomic<uint64_t> channel_grows_denied{0};  // Growth refused by the memory budget
+    std::atomic<uint64_t> timers_set{0};
+    std::atomic<uint64_t> timers_fired{0};
+    std::atomic<uint64_t> timers_cancelled{0};
+    std::atomic<int64_t> timer_lateness_us{0};  // Summed over fired timers
+    std::atomic<uint64_t> mail_sent{0};         // Process mail sent from this core
+    std::atomic<uint64_t> mail_local{0};        // Of those, put straight into a local mailbox
+    std::atomic<uint64_t> mail_delivered{0};    // Landed in a mailbox on this core
+    std::atomic<uint64_t> mail_forwarded{0};    // Arrived after the process moved on
+    std::atomic<uint64_t> mail_dropped{0};      // Mailbox full or process gone
+    std::atomic<uint64_t> name_cache_hits{0};   // resolve() calls answered from the cache
+    std::atomic<uint64_t> name_cache_misses{0}; // resolve() calls that went to the registry
+    std::atomic<uint64_t> name_updates{0};      // Cache entries replaced by an announcement
+    std::atomic<int> open_channels{0};          // Inbound channels currently set up
+    std::atomic<uint64_t> channel_bytes{0};     // Memory held by those channels
+    std::atomic<uint64_t> channels_opened{0};
+    std::atomic<uint64_t> channels_reclaimed{0};
+    std::atomic<uint64_t> self_messages{0};     // Took the same-core fast path
+    std::atomic<uint64_t> wakeups_sent{0};      // Sends that had to notify a parked receiver
+    std::atomic<uint64_t> wakeups_suppressed{0};// Sends that found the receiver awake
+    std::atomic<uint64_t> messages_refused{0};  // Sends pushed back by a full destination
+    std::atomic<uint64_t> messages_expired{0};  // Dropped at dequeue, past their deadline
 
     CoreStatistics() = default;
     CoreStatistics(const CoreStatistics& other) {
+        copy_from(other);
+    }
+    CoreStatistics& operator=(const CoreStatistics& other) {
+        if (this != &other) {
+            copy_from(other);
+        }
+        return *this;
+    }
+
+private:
+    void copy_from(const CoreStatistics& other) {
         messages_sent.store(other.messages_sent.load());
         messages_received.store(other.messages_received.load());
         processes_executed.store(other.processes_executed.load());
         context_switches.store(other.context_switches.load());
         avg_message_latency_us.store(other.avg_message_latency_us.load());
         current_load.store(other.current_load.load());
-    }
-    CoreStatistics& operator=(const CoreStatistics& other) {
-        if (this != &other) {
-            messages_sent.store(other.messages_sent.load());
-            messages_received.store(other.messages_received.load());
-            processes_executed.store(other.processes_executed.load());
-            context_switches.store(other.context_switches.load());
-            avg_message_latency_us.store(other.avg_message_latency_us.load());
-            current_load.store(other.current_load.load());
-        }
-        return *this;
+        message_time_us.store(other.message_time_us.load());
+        process_time_us.store(other.process_time_us.load());
+        budget_exhaustions.store(other.budget_exhaustions.load());
+        message_budget.store(other.message_budget.load());
+        urgent_messages.store(other.urgent_messages.load());
+        urgent_latency_us.store(other.urgent_latency_us.load());
+        preemptions.store(other.preemptions.load());
+        outbox_staged.store(other.outbox_staged.load());
+        outbox_refused.store(other.outbox_refused.load());
+        migrations_refused.store(other.migrations_refused.load());
+        outbox_flushes.store(other.outbox_flushes.load());
+        batched_pushes.store(other.batched_pushes.load());
+        coalesced_messages.store(other.coalesced_messages.load());
+        coalesced_units.store(other.coalesced_units.load());
+        coalesced_refused.store(other.coalesced_refused.load());
+        heartbeats_sent.store(other.heartbeats_sent.load());
+        peer_updates_piggybacked.store(other.peer_updates_piggybacked.load());
+        topic_published.store(other.topic_published.load());
+        topic_fanout.store(other.topic_fanout.load());
+        topic_delivered.store(other.topic_delivered.load());
+        topic_dropped.store(other.topic_dropped.load());
+        wire_messages.store(other.wire_messages.load());
+        wire_bytes.store(other.wire_bytes.load());
+        channel_grows.store(other.channel_grows.load());
+        channel_shrinks.store(other.channel_shrinks.load());
+        channel_grows_denied.store(other.channel_grows_denied.load());
+        timers_set.store(other.timers_set.load());
+        timers_fired.store(other.timers_fired.load());
+        timers_cancelled.store(other.timers_cancelled.load());
+        timer_lateness_us.store(other.timer_lateness_us.load());
+        mail_sent.store(other.mail_sent.load());
+        mail_local.store(other.mail_local.load());
+        mail_delivered.store(other.mail_delivered.load());
+        mail_forwarded.store(other.mail_forwarded.load());
+        mail_dropped.store(other.mail_dropped.load());
+        name_cache_hits.store(other.name_cache_hits.load());
+        name_cache_misses.store(other.name_cache_misses.load());
+        name_updates.store(other.name_updates.load());
+        open_channels.store(other.open_channels.load());
+        channel_bytes.store(other.channel_bytes.load());
+        channels_opened.store(other.channels_opened.load());
+        channels_reclaimed.store(other.channels_reclaimed.load());
+        self_messages.store(other.self_messages.load());
+        wakeups_sent.store(other.wakeups_sent.load());
+        wakeups_suppressed.store(other.wakeups_suppressed.load());
+        messages_refused.store(other.messages_refused.load());
+        messages_expired.store(other.messages_expired.load());
     }
 };
 
+inline int64_t steady_now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ============================================================================
+// HUGE PAGE ARENA - 2 MiB-backed memory for channel rings and PCBs
+// ============================================================================
+// Inboxes and process tables spread over many 4 KiB pages cost TLB misses as
+// they grow. Each core carves its channel rings and PCBs out of 2 MiB regions
+// instead: explicit huge pages (MAP_HUGETLB) if the system has them reserved,
+// otherwise a 2 MiB-aligned mapping advised for transparent huge pages,
+// otherwise plain pages. Set MULTIKERNEL_HUGEPAGES=0 to force plain pages.
+const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+enum PageBacking {
+    BACKING_NONE,            // Nothing mapped yet
+    BACKING_HUGETLB,         // Explicit 2 MiB pages
+    BACKING_THP,             // Transparent huge pages via madvise
+    BACKING_NORMAL           // 4 KiB pages (disabled or unavailable)
+};
+
+// Channel ring memory across all cores. Rings opened at their initial size
+// are always admitted; growth beyond that must fit in the budget.
+void set_channel_memory_budget(uint64_t bytes);
+uint64_t channel_memory_budget();
+uint64_t channel_memory_in_use();
+
+void set_hugepages_enabled(bool enabled);
+bool hugepages_enabled();
+const char* page_backing_name(PageBacking backing);
+
+class HugePageArena {
+private:
+    struct Region {
+        void* base;
+        size_t size;
+    };
+    std::vector<Region> regions;
+    char* bump = nullptr;
+    size_t remaining = 0;
+    std::map<size_t, std::vector<void*>> free_lists;   // Recycled blocks by size
+    std::mutex arena_mutex;
+    std::atomic<int> backing{BACKING_NONE};
+    std::atomic<uint64_t> bytes_mapped{0};
+    
+public:
+    HugePageArena() = default;
+    ~HugePageArena();
+    HugePageArena(const HugePageArena&) = delete;
+    HugePageArena& operator=(const HugePageArena&) = delete;
+    
+    void* allocate(size_t bytes);
+    void deallocate(void* ptr, size_t bytes);
+    
+    PageBacking get_backing() const { return static_cast<PageBacking>(backing.load()); }
+    uint64_t get_bytes_mapped() const { return bytes_mapped; }
+    
+private:
+    bool grow(size_t min_bytes);
+};
+
+// Allocator adaptor so std::allocate_shared can place objects in an arena.
+// It keeps the arena alive for as long as anything allocated from it is.
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+    std::shared_ptr<HugePageArena> arena;
+    
+    explicit ArenaAllocator(std::shared_ptr<HugePageArena> a) : arena(std::move(a)) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+    
+    T* allocate(size_t n) { return static_cast<T*>(arena->allocate(n * sizeof(T))); }
+    void deallocate(T* ptr, size_t n) { arena->deallocate(ptr, n * sizeof(T)); }
+    
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+};
+
+// ============================================================================
+// CHANNEL - Lazily established point-to-point link between two cores
+// ============================================================================
+// Channels are created on first use instead of up front, so interconnect
+// memory follows the pairs that actually talk rather than growing with N^2.
+// The receiving core owns the channel; the sender caches a reference to it.
+// Slots a record of `bytes` occupies in a channel ring
+inline size_t slots_for(size_t bytes) {
+    return (bytes + CHANNEL_SLOT_SIZE - 1) / CHANNEL_SLOT_SIZE;
+}
+
+// Slots in a ring that holds `capacity` full-size messages. Each one is
+// rounded up to whole slots, so this is more than capacity * sizeof(Message).
+inline size_t channel_slots(size_t capacity) {
+    return capacity * slots_for(MESSAGE_HEADER_SIZE + MAX_MESSAGE_SIZE);
+}
+
+// The ring is a run of CHANNEL_SLOT_SIZE slots. Each message takes the
+// slots its header and used payload need, contiguously: one that would
+// straddle the end of the ring starts over at slot 0 and the tail it skipped
+// is padding the reader steps over.
+class Channel {
+private:
+    int source_core;
+    int dest_core;
+    std::shared_ptr<HugePageArena> arena;   // Receiver's arena backs the ring
+    size_t slot_count;
+    uint8_t* ring;                      // Allocated once, when the link opens
+    size_t head = 0;                    // First slot of the oldest message
+    size_t used = 0;                    // Slots in use, padding included
+    size_t count = 0;                   // Messages queued
+    size_t pad_at = SIZE_MAX;           // Start of the skipped tail, if any
+    size_t pad_slots = 0;
+    bool closed = false;
+    size_t peak_used = 0;               // High-water mark since the last sample
+    size_t trough_used = 0;             // Low-water mark since the last sample
+    uint64_t refusals = 0;              // Pushes that did not fit, since the last sample
+    std::mutex channel_mutex;
+    std::atomic<int64_t> last_used_ms;  // steady_clock, for idle reclamation
+    std::atomic<uint64_t> bytes_written{0};
+
+    bool write_record(const Message& msg, const PeerMeta& meta);    // Caller holds the lock
+    void skip_padding();
+
+public:
+    // Sized to hold ring_capacity full-size messages; smaller ones pack tighter
+    Channel(int source, int dest, std::shared_ptr<HugePageArena> ring_arena,
+            size_t ring_capacity = CHANNEL_CAPACITY);
+    ~Channel();
+    Channel(const Channel&) = delete;
+    Channel& operator=(const Channel&) = delete;
+
+    bool push(const Message& msg, const PeerMeta& meta);    // False if full or reclaimed
+    size_t push_batch(const Message* msgs, size_t n, const PeerMeta& meta);  // How many fit
+    bool pop(Message& msg);
+    bool peek_deliver_at(std::chrono::steady_clock::time_point& when);
+    bool peek_size(size_t& bytes);      // Wire size of the head message
+    bool try_close();                   // Only succeeds while empty
+    bool is_closed();
+
+    bool is_idle(int64_t now_ms, int64_t idle_ms) const;
+    
+    // Adaptive capacity, driven by the receiving core's worker only.
+    // sample_pressure() returns and resets the refusals and the peak and
+    // trough fill (in slots) since the last call. resize() re-lays the
+    // queued messages into a new ring, failing if they would not fit.
+    void sample_pressure(uint64_t& refused, size_t& peak_slots, size_t& trough_slots);
+    bool resize(size_t new_slot_count);
+    size_t get_slot_count() const { return slot_count; }
+    size_t memory_bytes() const { return slot_count * CHANNEL_SLOT_SIZE; }
+    uint64_t get_bytes_written() const { return bytes_written.load(std::memory_order_relaxed); }
+    int get_source_core() const { return source_core; }
+    int get_dest_core() const { return dest_core; }
+};
+
+// ============================================================================
+// INTERCONNECT MODEL - Simulated NUMA latency, bandwidth and contention
+// ============================================================================
+// Lets placement and balancing be evaluated against hardware we don't have.
+// Cores are grouped into sockets; every socket pair shares one link with a
+// fixed latency (multiplied by remote_penalty across sockets) and a finite
+// bandwidth, so concurrent transfers over the same link queue behind each
+// other. In real-time mode receivers hold messages until their modeled
+// delivery time; in virtual-time mode they are delivered immediately but in
+// modeled order, and latency is reported in modeled time.
+struct InterconnectTopology {
+    int sockets = NUM_NODES;
+    int cores_per_socket = CORES_PER_NODE;
+    int64_t local_latency_ns = 200;         // Same-socket hop
+    double remote_penalty = 3.0;            // Cross-socket latency multiplier
+    double bandwidth_bytes_per_ns = 8.0;    // Per link (8 GB/s)
+    bool virtual_time = false;
+    
+    // e.g. "2x4", "2x4,local=150,remote=2.5,bw=4,virtual"
+    static bool parse(const std::string& spec, InterconnectTopology& out);
+};
+
+class InterconnectModel {
+private:
+    InterconnectTopology topology;
+    
+    struct Link {
+        std::mutex link_mutex;
+        int64_t busy_until_ns = 0;
+    };
+    std::vector<std::unique_ptr<Link>> links;   // sockets x sockets
+    
+    // Statistics
+    std::atomic<uint64_t> messages_modeled{0};
+    std::atomic<uint64_t> remote_messages{0};
+    std::atomic<uint64_t> total_latency_ns{0};
+    std::atomic<uint64_t> contention_ns{0};
+    
+public:
+    explicit InterconnectModel(const InterconnectTopology& topo);
+    
+    // Reserve the link and return when the message may be delivered
+    std::chrono::steady_clock::time_point schedule(int source_core, int dest_core,
+                                                   size_t bytes,
+                                                   std::chrono::steady_clock::time_point now);
+    
+    int socket_of(int core) const;
+    bool is_virtual_time() const { return topology.virtual_time; }
+    const InterconnectTopology& get_topology() const { return topology; }
+    void print_statistics() const;
+};
+
+// ============================================================================
+// TOPIC DIRECTORY - Named publish/subscribe topics
+// ============================================================================
+// Maps topic names to small ids and keeps, per topic, a bitmask of the cores
+// subscribed to it. Publishers read the mask with one atomic load and send a
+// copy to each subscriber only; the names map is touched when a topic is
+// first looked up, never on the publish path.
+static_assert(NUM_CORES <= 64, "Subscriber masks hold one bit per core");
+
+class TopicDirectory {
+private:
+    std::mutex names_mutex;
+    std::map<std::string, int> names;
+    std::atomic<uint64_t> subscribers[MAX_TOPICS] = {};
+    
+public:
+    // Topic id for a name, registering it if new; -1 when MAX_TOPICS are taken
+    int lookup(const std::string& name);
+    
+    void subscribe(int topic, int core);
+    void unsubscribe(int topic, int core);
+    bool is_subscribed(int topic, int core) const;
+    uint64_t subscribers_of(int topic) const;
+};
+
+// ============================================================================
+// PROCESS DIRECTORY - Which core each PID lives on
+// ============================================================================
+// Written when a process is created, lands after a migration or exits; read
+// on every mail send. Sharded by PID so senders rarely share a lock.
+class ProcessDirectory {
+private:
+    struct alignas(CACHE_LINE_SIZE) Shard {
+        mutable std::mutex shard_mutex;
+        std::unordered_map<int, int> cores;
+    };
+    Shard shards[PROCESS_DIRECTORY_SHARDS];
+    
+    Shard& shard_of(int pid) { return shards[static_cast<unsigned>(pid) % PROCESS_DIRECTORY_SHARDS]; }
+    const Shard& shard_of(int pid) const { return shards[static_cast<unsigned>(pid) % PROCESS_DIRECTORY_SHARDS]; }
+    
+public:
+    void place(int pid, int core);
+    void remove(int pid, int core);     // Only if pid is still placed on core
+    bool move(int pid, int from, int to);   // Only if pid is still placed on from
+    int core_of(int pid) const;         // -1 if unknown
+};
+
+// ============================================================================
+// NAME SERVICE - Well-known names for services, resolved per core
+// ============================================================================
+// The registry is authoritative; cores cache what they resolve and are told
+// of every change on the "sys.names" topic. Each change carries a generation
+// so a core never lets an older answer replace a newer one.
+struct ServiceAddress {
+    int core = -1;
+    int port = -1;
+};
+
+class NameService {
+public:
+    struct Change {
+        std::string name;
+        ServiceAddress address;         // core -1: the name was removed
+        uint64_t generation;
+    };
+    
+private:
+    struct Entry {
+        ServiceAddress address;
+        int owner_pid;                  // -1: bound to the core, not a process
+        uint64_t generation;
+    };
+    
+    mutable std::mutex names_mutex;
+    std::unordered_map<std::string, Entry> entries;
+    uint64_t generation = 0;
+    
+public:
+    Change bind(const std::string& name, ServiceAddress address, int owner_pid);
+    bool unbind(const std::string& name, Change& change);   // False if not bound
+    bool lookup(const std::string& name, ServiceAddress& address, uint64_t& entry_generation) const;
+    
+    // Names owned by a process follow it to a new core, or go when it exits
+    std::vector<Change> rehome(int owner_pid, int core);
+    std::vector<Change> release(int owner_pid);
+};
+
+// ============================================================================
+// TIMER WHEEL - Hierarchical timing wheel for per-core timeouts
+// ============================================================================
+// Four levels of 256 slots each. Level 0 holds timers due within 256 ticks;
+// each level above covers 256 times the span of the one below, and its slots
+// cascade down as time reaches them. Timers live in a pool and are linked
+// into their slot by index, so schedule and cancel are O(1); advancing costs
+// one step per non-empty tick plus the occasional cascade. Not thread-safe:
+// the owner serializes access.
+class TimerWheel {
+public:
+    using Callback = std::function<void()>;
+    static const uint64_t NO_TIMER = 0;
+    
+private:
+    static const int LEVELS = 4;
+    static const int SLOT_BITS = 8;
+    static const int SLOTS = 1 << SLOT_BITS;
+    static constexpr uint32_t NIL = UINT32_MAX;
+    
+    struct Node {
+        uint64_t expires = 0;           // In ticks
+        uint32_t prev = NIL;
+        uint32_t next = NIL;
+        uint32_t generation = 1;        // Bumped on free, so stale ids miss
+        uint16_t level = 0;
+        uint16_t slot = 0;
+        bool armed = false;
+        Callback callback;
+    };
+    
+    std::vector<Node> nodes;
+    std::vector<uint32_t> free_nodes;
+    uint32_t heads[LEVELS][SLOTS];
+    uint64_t occupied[LEVELS][SLOTS / 64] = {};
+    std::chrono::steady_clock::time_point origin;
+    std::chrono::microseconds tick;
+    uint64_t current = 0;               // Next tick to process
+    size_t armed_count = 0;
+    
+    void link(uint32_t index);
+    void unlink(uint32_t index);
+    void release(uint32_t index);
+    bool cascade(int level);            // True if the level above must cascade too
+    int next_level0_slot() const;       // Circularly from current; -1 if empty
+    bool higher_levels_occupied() const;
+    
+public:
+    explicit TimerWheel(std::chrono::microseconds tick_length =
+                            std::chrono::microseconds(TIMER_WHEEL_TICK_US),
+                        std::chrono::steady_clock::time_point start =
+                            std::chrono::steady_clock::now());
+    
+    // Returns an id for cancel(); never NO_TIMER
+    uint64_t schedule(std::chrono::steady_clock::time_point when, Callback callback);
+    bool cancel(uint64_t id);           // False if it already fired or was cancelled
+    
+    // Moves every timer due by `now` into `due`, in expiry-tick order, for
+    // the caller to run once it has released whatever guards the wheel
+    size_t advance(std::chrono::steady_clock::time_point now, std::vector<Callback>& due);
+    
+    // Earliest time anything may be due, for the owner's park deadline;
+    // time_point::max() when empty. May be early (a cascade point), never late.
+    std::chrono::steady_clock::time_point next_deadline() const;
+    
+    size_t size() const { return armed_count; }
+};
+
 // ============================================================================
 // CORE KERNEL - Per-core OS instance
 // ============================================================================
-class CoreKernel {
+// Members are grouped by who writes them, and each group starts on its own
+// cache line: remote senders hammering the inbox lock must not invalidate
+// the lines the owning worker reads on every iteration.
+class WaitSet;
+struct WaitEvent;
+
+class alignas(CACHE_LINE_SIZE) CoreKernel {
 private:
-    int core_id;
+    // ---- Read-mostly: fixed after start(), read on every send/iteration ----
+    alignas(CACHE_LINE_SIZE) int core_id;
     std::atomic<bool> running;
+    std::atomic<std::thread::id> worker_id; // Self-sends from here skip the inbox
+    std::atomic<int> message_time_budget_us{MESSAGE_TIME_BUDGET_US};
+    std::atomic<bool> adaptive_budget{true};
+    std::atomic<int> process_slice_us{0};   // Busy time per simulated slice
+    
+    // Per message type: how long a send may be held for coalescing (0 = never)
+    // and how many held messages publish a unit early
+    std::atomic<int> coalesce_delay_us[MSG_TYPE_COUNT] = {};
+    std::atomic<int> coalesce_batch[MSG_TYPE_COUNT] = {};
+    
+    // Reference to other cores for message routing
+    std::vector<CoreKernel*>* all_cores;
+    InterconnectModel* interconnect = nullptr;  // Optional transport model
+    TopicDirectory* topics = nullptr;           // Shared subscriber masks
+    ProcessDirectory* processes = nullptr;      // Shared PID-to-core map
+    NameService* names = nullptr;               // Authoritative name registry
     
-    // Message passing infrastructure
-    std::queue<Message> inbox;
-    std::mutex inbox_mutex;
+    // Backing store for inbound channel rings and PCBs
+    std::shared_ptr<HugePageArena> arena;
+    
+    // ---- Producer-written: touched by every core that sends to us ----
+    alignas(CACHE_LINE_SIZE) std::mutex inbox_mutex;
     std::condition_variable inbox_cv;
+    // Bootstrap channel, always present. Each entry remembers which quota it
+    // was charged to: a local core, EXTERNAL_QUOTA_SLOT or none (-1).
+    struct BootstrapEntry {
+        Message msg;
+        int quota_slot;
+    };
+    static const int EXTERNAL_QUOTA_SLOT = NUM_CORES;   // Every external link shares one
+    std::queue<BootstrapEntry> inbox;
+    int inbox_by_source[NUM_CORES + 1] = {};    // Data messages per quota slot
+    std::atomic<int> pending_messages{0};
+    std::atomic<int> sleepers{0};       // Receivers parked (or about to park) on inbox_cv
+    std::atomic<bool> wake_pending{false};  // A notify is already on its way
+    std::atomic<bool> preempt_requested{false}; // Urgent message waiting; checked at safe points
+    std::atomic<bool> kicked{false};    // Worker must recompute its park deadline
+    std::atomic<bool> inbox_armed{false};   // The worker's WaitSet wants the next arrival signalled
+    int inbox_fd = -1;                  // eventfd behind that signal, open for the core's lifetime
+    
+    // ---- Consumer-owned: touched by this core's worker ----
+    // Inbound channels, indexed by source core and created on demand
+    alignas(CACHE_LINE_SIZE) std::vector<std::shared_ptr<Channel>> rx_channels;
+    std::mutex rx_mutex;
+    size_t rx_cursor = 0;               // Source whose deficit round-robin turn it is
+    std::vector<size_t> rx_deficit;     // Unspent byte credit per source
+    bool rx_turn_open = false;          // rx_cursor already got this round's quantum
+    
+    // What this core last heard from each peer, piggybacked on its traffic
+    struct PeerState {
+        std::atomic<int> load{-1};
+        std::atomic<uint32_t> epoch{0};
+        std::atomic<int64_t> heard_ms{0};
+    };
+    PeerState peers[NUM_CORES];
+    std::atomic<uint32_t> epoch{0};     // Scheduler ticks so far; our own liveness
+    int64_t last_heartbeat_ms = 0;
+    int64_t last_resize_ms = 0;
+    int rx_quiet_windows[NUM_CORES] = {};   // Per source: samples in a row with little use
+    bool rx_growth_held[NUM_CORES] = {};    // Per source: refusal to grow already logged
+    
+    // Messages this core's worker sent to itself; only the worker touches it,
+    // so it needs no lock and no wakeup
+    std::deque<Message> local_queue;
+    
+    // What the worker parks on: its inbox, plus the deadline of the pass
+    std::unique_ptr<WaitSet> worker_waits;
+    std::vector<WaitEvent> worker_ready;
+    int inbox_backlog = 0;              // Held-back messages an armed inbox ignores
+    
+    // Messages handled per worker pass before processes get their turn
+    std::atomic<int> message_budget{MESSAGE_BUDGET_INITIAL};
     
     // Process management
     std::vector<std::shared_ptr<ProcessControlBlock>> process_table;
     std::mutex process_mutex;
     
-    // Statistics
-    CoreStatistics stats;
+    // Outbound channels this core has established, indexed by destination
+    alignas(CACHE_LINE_SIZE) std::vector<std::shared_ptr<Channel>> tx_channels;
+    std::vector<int64_t> tx_open_sent_ms;   // OPEN sent, waiting for the ACK
+    std::mutex tx_mutex;
     
-    // Worker thread
-    std::thread worker_thread;
+    // Sends held for coalescing, per destination, published by the worker
+    // once the oldest is due or a unit fills up
+    alignas(CACHE_LINE_SIZE) std::mutex coalesce_mutex;
+    std::vector<std::vector<Message>> coalesce_buf;
+    std::vector<int64_t> coalesce_due_ns;   // Per destination; INT64_MAX when empty
+    std::atomic<int64_t> coalesce_next_due_ns{INT64_MAX};
+    std::atomic<bool> coalesce_held[NUM_CORES] = {};
     
-    // Reference to other cores for message routing
-    std::vector<CoreKernel*>* all_cores;
+    // Sends staged by handlers and the scheduler, flushed once their locks
+    // are released
+    alignas(CACHE_LINE_SIZE) std::mutex outbox_mutex;
+    std::vector<Message> outbox;
+    std::mutex flush_mutex;             // Keeps concurrent flushes in staging order
+    
+    // Handlers for the topics this core subscribes to, run by the worker
+    std::map<int, std::function<void(const Message&)>> topic_handlers;
+    std::mutex topic_mutex;
+    
+    // One-shot timers, fired by the worker; any thread may set or cancel
+    alignas(CACHE_LINE_SIZE) std::mutex timer_mutex;
+    TimerWheel timers;
+    std::vector<TimerWheel::Callback> timers_due;   // Worker only
+    
+    // This core's copy of the names it has resolved, kept current by the
+    // names topic; removed names stay as tombstones with their generation
+    alignas(CACHE_LINE_SIZE) std::mutex name_mutex;
+    struct CachedName {
+        ServiceAddress address;
+        uint64_t generation;
+    };
+    std::unordered_map<std::string, CachedName> name_cache;
+    uint64_t name_hits = 0;                 // Off-worker hits, under name_mutex
+    std::atomic<uint64_t> name_epoch{0};    // Bumped under name_mutex by every cache write
+    
+    // The worker's unlocked copy of name_cache, current while its epoch matches
+    std::unordered_map<std::string, CachedName> worker_names;   // Worker only
+    uint64_t worker_names_epoch = 0;                            // Worker only
+    std::atomic<uint64_t> worker_name_hits{0};                  // Written by the worker only
+    std::atomic<int> names_topic{-1};
+    
+    // ---- Statistics: written by the owner, read by monitors ----
+    alignas(CACHE_LINE_SIZE) CoreStatistics stats;
+    
+    // Worker thread (cold)
+    std::thread worker_thread;
     
 public:
     CoreKernel(int id);
     ~CoreKernel();
     
     // Lifecycle management
-    void start(std::vector<CoreKernel*>* cores);
+    void start(std::vector<CoreKernel*>* cores, InterconnectModel* model = nullptr,
+               TopicDirectory* directory = nullptr, ProcessDirectory* pids = nullptr,
+               NameService* registry = nullptr);
     void stop();
     bool is_running() const { return running; }
     
     // Message passing
-    void send_message(const Message& msg);
+    bool send_message(const Message& msg);      // False if the destination pushed back
+    bool deliver_external(const Message& msg);  // From outside the core mesh
     bool receive_message(Message& msg, int timeout_ms = 0);
     void broadcast_message(const Message& msg);
     
+    // Stage a send to go out with the next flush, grouped per destination.
+    // Safe to call with locks held; call flush_outbox() only after releasing them.
+    void stage_message(const Message& msg);
+    size_t flush_outbox();              // Returns how many staged sends were refused
+    
+    // Let sends of this type wait up to max_delay_us to share one publish
+    // with others to the same destination; 0 turns coalescing off
+    void set_coalescing(MessageType type, int max_delay_us, int max_batch = 16);
+    
+    // Publish/subscribe. subscribe() returns the topic id (-1 if the directory
+    // is full); the handler runs on this core's worker for every update.
+    // publish() sends one copy per subscriber and returns how many it reached.
+    int subscribe(const std::string& topic, std::function<void(const Message&)> handler);
+    void unsubscribe(int topic);
+    int publish(int topic, const Message& msg);
+    
+    // One-shot timers. The callback runs on this core's worker no earlier
+    // than `delay` from now and within a wheel tick of it when the core is
+    // not busy. cancel_timer() is false once the timer has fired.
+    uint64_t set_timer(std::chrono::microseconds delay, std::function<void()> callback);
+    bool cancel_timer(uint64_t id);
+    
+    // Process mailboxes. send_mail() finds the core that owns `pid` and
+    // delivers there; mail to a process on this core skips the channels
+    // entirely. False if the pid is unknown or its local mailbox is full;
+    // cross-core mail that finds the mailbox full is dropped and counted.
+    // receive_mail() is for a process on this core and waits up to
+    // timeout_ms; false on timeout or once the process has left the core.
+    bool send_mail(int pid, const Message& msg);
+    bool receive_mail(int pid, Message& msg, int timeout_ms = 0);
+    
+    // Name service. register_service() binds a name to (this core, port),
+    // replacing any earlier binding; with an owner pid the name follows that
+    // process when it migrates and is removed when it exits. resolve() is a
+    // local hash lookup once this core has the name cached, and on this
+    // core's worker it takes no lock.
+    bool register_service(const std::string& name, int port, int owner_pid = -1);
+    bool unregister_service(const std::string& name);
+    bool resolve(const std::string& name, ServiceAddress& address);
+    
+    // Per-pass message handling limits; adaptive mode retunes the count
+    void set_message_budget(int messages, int time_us = MESSAGE_TIME_BUDGET_US,
+                            bool adaptive = true);
+    
     // Process management
     int create_process(int priority = 5);
+    // Make each simulated slice take real time (0, the default, takes none)
+    void set_process_slice(int us) { process_slice_us = us; }
+    void create_process_batch(const std::vector<int>& priorities, std::vector<int>& pids);
     bool migrate_process(int pid, int target_core);
     void terminate_process(int pid);
     
     // Statistics and monitoring
-    CoreStatistics get_statistics() const { return stats; }
+    CoreStatistics get_statistics() const {
+        CoreStatistics copy = stats;
+        copy.name_cache_hits += worker_name_hits.load(std::memory_order_relaxed);
+        return copy;
+    }
     int get_load() const { return stats.current_load; }
+    PageBacking get_page_backing() const { return arena->get_backing(); }
+    uint64_t get_arena_bytes() const { return arena->get_bytes_mapped(); }
     int get_core_id() const { return core_id; }
     
+    // Mailbox readiness for a WaitSet. watch_mailbox() gives the PCB an
+    // eventfd (null if the pid is not on this core); after arm_mailbox() it
+    // becomes readable on the next arrival, or at once if mail is already
+    // waiting or the process has left.
+    std::shared_ptr<ProcessControlBlock> watch_mailbox(int pid);
+    static void arm_mailbox(ProcessControlBlock& pcb);
+    
+    // Inbox readiness for a WaitSet, owner only: the worker is the one thread
+    // that drains the inbox, so no other may wait on it. watch_inbox() returns
+    // the eventfd, or -1 off the worker; after arm_inbox() it becomes readable
+    // on the next arrival, or at once if messages are already pending.
+    int watch_inbox() const;
+    void arm_inbox();
+    
+    // Freshest piggybacked state from a peer; false if never heard from
+    bool get_peer_state(int core, int& load, uint32_t& peer_epoch, int64_t& age_ms) const;
+    
 private:
     void worker_loop();
+    bool handle_messages();             // True if the budget ran out first
+    void adapt_budget(std::chrono::steady_clock::duration tick_lateness, bool exhausted);
     void process_message(const Message& msg);
-    void execute_processes();
+    // Returns the time spent handling messages when a pass was preempted
+    std::chrono::steady_clock::duration execute_processes();
     void handle_process_create(const Message& msg);
     void handle_process_migrate(const Message& msg);
+    void handle_process_migrate_ack(const Message& msg);
+    void hand_off_process(int pid, int target_core);
     void handle_process_terminate(const Message& msg);
+    std::shared_ptr<ProcessControlBlock> new_pcb(int pid, int priority);
+    
+    // Channel management
+    bool route_message(const Message& msg);
+    size_t send_batch(int dest_core, const std::vector<Message>& msgs);  // Returns refusals
+    bool transmit(const Message& msg);  // Coalesce or route a validated, stamped send
+    bool coalesce(const Message& msg, int delay_us);
+    void publish_locked(int dest_core); // Caller holds coalesce_mutex
+    void publish_due(bool force);
+    void kick();
+    // Caller wakes. External messages come from another node or an outside
+    // producer, so their source_core does not name a local core.
+    bool post_bootstrap(const Message& msg, const PeerMeta& meta = PeerMeta(),
+                        bool external = false);
+    PeerMeta own_meta() const;
+    void note_peer(const Message& msg);
+    void send_idle_heartbeats();
+    void pop_bootstrap(Message& msg);   // Caller holds inbox_mutex; inbox not empty
+    bool pop_fair(Message& msg);        // Caller holds rx_mutex
+    bool pop_live(Message& msg);        // pop_any, discarding expired messages
+    std::chrono::steady_clock::time_point arrival_time(const Message& msg) const;
+    bool wake();                        // True if a parked receiver had to be notified
+    void signal_inbox();
+    void note_wake(bool notified);
+    void park_until(std::chrono::steady_clock::time_point deadline, int backlog);
+    bool pop_any(Message& msg);
+    bool on_worker_thread() const;
+    bool pop_modeled(Message& msg);
+    void note_received(const Message& msg);
+    void handle_channel_open(const Message& msg);
+    void handle_channel_ack(const Message& msg);
+    void handle_topic_update(const Message& msg);
+    bool deliver_mail(const Message& msg);  // False if dropped
+    std::shared_ptr<ProcessControlBlock> find_process(int pid);  // Caller holds process_mutex
+    void release_process(ProcessControlBlock& pcb);  // Caller holds process_mutex
+    int stage_publish(int topic, const Message& msg);   // publish() without the flush
+    int join_names_topic();             // Subscribes on first use; -1 without topics
+    void cache_name(const std::string& name, ServiceAddress address, uint64_t generation);
+    void announce_names(const std::vector<NameService::Change>& changes);  // Stages only
+    void handle_name_update(const Message& msg);
+    std::shared_ptr<Channel> find_rx_channel(int source);
+    void reclaim_idle_channels();
+    void adapt_channel_capacity();
+    void fire_timers();
+};
+
+// ============================================================================
+// WAIT SET - Block on several cores, timers and file descriptors at once
+// ============================================================================
+// epoll underneath: each process mailbox contributes its eventfd, each timer
+// a timerfd, and external fds (eventfds, sockets) are watched as given. wait()
+// returns every source that is ready, so one event loop can mix messaging and
+// I/O. Mailboxes are filled by their core's worker and drained only by the
+// thread running the process, so the wait set never competes with a worker.
+// A core's inbox can only be watched from that core's worker, which is how
+// the worker itself parks. Mailbox and inbox readiness is level-triggered:
+// drain after it is reported, or the next wait() returns at once.
+enum WaitSourceKind {
+    WAIT_MAIL,      // Mail pending for a process, or the process has left the core
+    WAIT_INBOX,     // Messages pending for the core whose worker is waiting
+    WAIT_TIMER,     // A timer fired (count = expirations)
+    WAIT_FD         // An external fd is readable; the caller consumes it
+};
+
+struct WaitEvent {
+    int id;                 // As returned by the add_* call
+    WaitSourceKind kind;
+    uint64_t count;         // Timer expirations; 1 for the other kinds
+};
+
+class WaitSet {
+private:
+    struct Source {
+        WaitSourceKind kind;
+        int fd;
+        std::shared_ptr<ProcessControlBlock> process;   // WAIT_MAIL only
+        CoreKernel* core;                               // WAIT_INBOX only
+    };
+    
+    int epoll_fd;
+    int deadline_fd = -1;       // One-shot timerfd behind wait_until, made on first use
+    std::map<int, Source> sources;
+    std::mutex sources_mutex;
+    int next_id = 0;
+    
+    int add_source(WaitSourceKind kind, int fd, std::shared_ptr<ProcessControlBlock> process,
+                   CoreKernel* core = nullptr);
+    int collect(std::vector<WaitEvent>& ready, int timeout_ms);
+    
+public:
+    WaitSet();
+    ~WaitSet();
+    WaitSet(const WaitSet&) = delete;
+    WaitSet& operator=(const WaitSet&) = delete;
+    
+    // Each returns a source id, or -1 on failure. A mailbox whose process
+    // leaves stays ready until removed; receive_mail() then returns false.
+    int add_mailbox(CoreKernel* core, int pid);
+    int add_inbox(CoreKernel* core);    // Only on that core's worker thread
+    int add_timer(std::chrono::microseconds interval, bool periodic = true);
+    int add_fd(int fd);
+    bool remove(int id);
+    
+    // Fills `ready` and returns how many sources are ready; 0 on timeout.
+    // A negative timeout waits indefinitely.
+    int wait(std::vector<WaitEvent>& ready, int timeout_ms);
+    
+    // The same, but waits until a steady_clock time with timerfd precision
+    int wait_until(std::vector<WaitEvent>& ready, std::chrono::steady_clock::time_point deadline);
+};
+
+// ============================================================================
+// SPSC RING - Lock-free single-producer/single-consumer queue
+// ============================================================================
+// Head and tail live on separate cache lines so the producer and consumer
+// never write the same line.
+template <typename T, size_t N>
+class SpscRing {
+    static_assert((N & (N - 1)) == 0, "ring size must be a power of two");
+    
+private:
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head{0};   // Written by the consumer
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail{0};   // Written by the producer
+    alignas(CACHE_LINE_SIZE) T buffer[N];
+    
+public:
+    bool push(const T& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == N) {
+            return false;
+        }
+        buffer[t & (N - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+    
+    bool pop(T& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = buffer[h & (N - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+    
+    size_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+    size_t free_space() const { return N - size(); }
+};
+
+// ============================================================================
+// CLIENT QUEUES - Per-client submission and completion rings
+// ============================================================================
+// Modelled on io_uring: a registered client pushes entries into its own
+// submission ring and reaps results from its own completion ring. A node
+// coordinator drains submissions in batches, so clients never take a lock.
+enum SubmissionOp {
+    SUBMIT_CREATE,           // priority -> result is the new PID
+    SUBMIT_TERMINATE,        // pid on target_core (same node) -> result 0
+    SUBMIT_BALANCE           // rebalance the owning node -> result 0
+};
+
+struct SubmissionEntry {
+    SubmissionOp op = SUBMIT_CREATE;
+    int priority = 5;
+    int pid = -1;
+    int target_core = -1;
+    uint64_t user_data = 0;             // Echoed back in the completion
+};
+
+struct CompletionEntry {
+    uint64_t user_data = 0;
+    int result = -1;
+};
+
+class NodeCoordinator;
+
+class ClientQueues {
+private:
+    int client_id;
+    NodeCoordinator* node;              // Drains this client
+    SpscRing<SubmissionEntry, SUBMISSION_RING_SIZE> sq;
+    SpscRing<CompletionEntry, SUBMISSION_RING_SIZE> cq;
+    
+    friend class NodeCoordinator;
+    
+public:
+    ClientQueues(int id, NodeCoordinator* owner) : client_id(id), node(owner) {}
+    
+    bool submit(const SubmissionEntry& entry);   // False if the ring is full
+    int reap(CompletionEntry* out, int max_entries);
+    int get_client_id() const { return client_id; }
+};
+
+// ============================================================================
+// NODE COORDINATOR - Placement and balancing for one NUMA node
+// ============================================================================
+// Each node coordinates only its own cores under its own lock, so creation
+// and balancing on different nodes never contend. The system escalates to
+// another node only when this one is saturated.
+class NodeCoordinator {
+private:
+    int node_id;
+    std::vector<CoreKernel*> node_cores;
+    std::mutex node_mutex;
+    
+    // Batched ingestion of client submission rings
+    std::vector<ClientQueues*> clients;
+    std::mutex clients_mutex;
+    std::thread ingest_thread;
+    std::atomic<bool> ingesting{false};
+    std::atomic<bool> ingest_sleeping{false};
+    std::mutex ingest_mutex;
+    std::condition_variable ingest_cv;
+    std::atomic<uint64_t> entries_ingested{0};
+    std::atomic<uint64_t> ingest_batches{0};
+    
+public:
+    NodeCoordinator(int id, std::vector<CoreKernel*> cores);
+    ~NodeCoordinator();
+    
+    // Place a process on this node; -1 if saturated and not forced
+    int create_process(int priority, int& placed_core, bool force = false);
+    void create_process_batch(const std::vector<int>& priorities, std::vector<int>& pids);
+    void balance_load();
+    
+    // Client submission rings
+    void attach_client(ClientQueues* client);
+    void start_ingestion();
+    void stop_ingestion();
+    void ring_doorbell();
+    uint64_t get_entries_ingested() const { return entries_ingested; }
+    uint64_t get_ingest_batches() const { return ingest_batches; }
+    
+    int get_least_loaded_core();        // Global core ID
+    int get_total_load() const;
+    bool is_saturated() const;
+    int get_node_id() const { return node_id; }
+    bool owns_core(int core) const;
+    
+private:
+    int least_loaded_index() const;
+    CoreKernel* find_core(int core);
+    void ingest_loop();
+    int drain_client(ClientQueues* client);
 };
 
 // ============================================================================
 // MULTIKERNEL SYSTEM - System coordinator
 // ============================================================================
+struct ChannelSample {
+    std::chrono::steady_clock::time_point when;
+    int open_channels;
+    uint64_t channel_bytes;
+};
+
 class MultikernelSystem {
 private:
     std::vector<std::unique_ptr<CoreKernel>> cores;
+    std::vector<CoreKernel*> core_ptrs;     // Routing table shared with cores
+    std::vector<std::unique_ptr<NodeCoordinator>> nodes;
+    std::unique_ptr<InterconnectModel> interconnect;
+    TopicDirectory topics;
+    ProcessDirectory processes;
+    NameService names;
+    std::chrono::steady_clock::time_point start_time;
+    std::vector<ChannelSample> channel_history;
     std::atomic<int> next_pid{0};
     std::atomic<bool> system_running{false};
     
-    // Load balancing
-    std::mutex load_balancer_mutex;
+    // Cross-node escalation (only taken when a node is saturated)
+    std::mutex escalation_mutex;
+    std::atomic<uint64_t> escalations{0};
+    
+    // Registered submission-ring clients
+    std::vector<std::unique_ptr<ClientQueues>> clients;
+    std::mutex clients_mutex;
     
 public:
     MultikernelSystem();
@@ -189,20 +1219,175 @@ public:
     // System lifecycle
     void start();
     void shutdown();
+    void set_interconnect_model(const InterconnectTopology& topology);  // Before start()
+    void set_coalescing(MessageType type, int max_delay_us, int max_batch = 16);
     
     // Process management (delegates to least loaded core)
     int create_process(int priority = 5);
+    void create_process_batch(const std::vector<int>& priorities, std::vector<int>& pids);
     bool migrate_process(int pid, int source_core, int target_core);
     
+    // Lock-free submission path for external producers
+    ClientQueues* register_client();
+    
+    // Inject a message that arrived from outside this system (e.g. another node)
+    bool deliver_message(const Message& msg);
+    
     // Load balancing
     void balance_load();
     int get_least_loaded_core();
+    int get_home_node() const;
+    
+    // Direct access to a core, for diagnostics and benchmarks
+    CoreKernel* get_core(int id) { return cores[id].get(); }
     
     // System-wide statistics
     void print_statistics();
+    void sample_channel_usage();
+    void print_channel_report();
     
 private:
     void load_balancer_thread();
 };
 
+// ============================================================================
+// COMBINING FRONT END - Flat combining for concurrent client calls
+// ============================================================================
+// Clients publish requests into their own slot instead of calling into the
+// system directly. Whichever client grabs the combiner lock serves every
+// pending slot in one pass: creates become a single batched placement, and
+// any number of balance requests collapse into one balance_load().
+enum CombinedOp {
+    COMBINE_CREATE,
+    COMBINE_BALANCE
+};
+
+enum SlotState {
+    SLOT_FREE,
+    SLOT_PENDING,
+    SLOT_DONE
+};
+
+struct alignas(CACHE_LINE_SIZE) CombiningSlot {
+    std::atomic<int> state{SLOT_FREE};
+    CombinedOp op = COMBINE_CREATE;
+    int priority = 5;
+    int result = -1;
+};
+
+// Slots given back by exited threads. Shared with those threads' leases so
+// a thread that outlives its front end has nothing left to return to.
+struct CombiningSlotPool {
+    std::mutex mutex;
+    std::vector<int> free_slots;
+};
+
+class CombiningFrontEnd {
+private:
+    MultikernelSystem& system;
+    std::vector<CombiningSlot> slots;
+    std::atomic<int> registered_slots{0};   // Slots ever handed out; combine() scans these
+    std::shared_ptr<CombiningSlotPool> pool;
+    std::mutex combiner_mutex;
+    
+    // Statistics
+    std::atomic<uint64_t> combine_passes{0};
+    std::atomic<uint64_t> combined_requests{0};
+    
+public:
+    explicit CombiningFrontEnd(MultikernelSystem& sys);
+    
+    int create_process(int priority = 5);
+    void balance_load();
+    
+    double get_average_batch() const;
+    uint64_t get_combine_passes() const { return combine_passes; }
+    uint64_t get_combined_requests() const { return combined_requests; }
+    
+private:
+    CombiningSlot* acquire_slot();
+    int lease_slot();
+    void wait_for(CombiningSlot* slot);
+    void combine();
+};
+
+// ============================================================================
+// CLUSTER NODE - Several MultikernelSystems joined over Unix domain sockets
+// ============================================================================
+// Every core is globally addressable as (node, core). Node-local messages
+// are delivered straight into the local system; cross-node messages are
+// batched per peer into versioned binary frames and carried over a Unix
+// domain socket, then injected into the destination core on arrival.
+const uint32_t CLUSTER_FRAME_MAGIC = 0x4D4B434C;   // "MKCL"
+const uint16_t CLUSTER_FRAME_VERSION = 6;    // 2: records carry expires_at; 3: topic; 4: MSG_PROCESS_MAIL; 5: urgent; 6: MSG_PROCESS_MIGRATE_ACK
+
+struct GlobalCoreId {
+    int node;
+    int core;
+};
+
+struct ClusterEnvelope {
+    GlobalCoreId source;
+    GlobalCoreId dest;
+    Message msg;
+};
+
+// Frame encoding: 12-byte header (magic, version, count, body length), then
+// `count` records, each carrying only the used part of the payload
+std::vector<uint8_t> encode_cluster_frame(const std::vector<ClusterEnvelope>& batch);
+bool decode_cluster_frame_header(const uint8_t* header, uint16_t& count, uint32_t& body_len);
+bool decode_cluster_frame_body(const uint8_t* body, uint32_t body_len, uint16_t count,
+                               std::vector<ClusterEnvelope>& out);
+
+struct ClusterPeer {
+    int fd = -1;
+    std::vector<ClusterEnvelope> pending;   // Waiting for the next frame
+    std::mutex peer_mutex;
+};
+
+class ClusterNode {
+private:
+    int node_id;
+    int num_nodes;
+    std::string socket_dir;
+    MultikernelSystem system;
+    
+    std::atomic<bool> running{false};
+    int listen_fd = -1;
+    std::vector<std::unique_ptr<ClusterPeer>> peers;   // Indexed by node
+    std::thread receiver_thread;
+    std::thread flusher_thread;
+    
+    // Delivery latency, send() to injection into the destination core
+    std::atomic<uint64_t> local_messages{0};
+    std::atomic<uint64_t> local_latency_ns{0};
+    std::atomic<uint64_t> remote_messages{0};
+    std::atomic<uint64_t> remote_latency_ns{0};
+    std::atomic<uint64_t> frames_sent{0};
+    std::atomic<uint64_t> frames_received{0};
+    
+public:
+    ClusterNode(int id, int nodes, const std::string& dir = "/tmp");
+    ~ClusterNode();
+    
+    void start();
+    void stop();
+    
+    bool send(GlobalCoreId source, GlobalCoreId dest, const Message& msg);
+    void flush();
+    bool wait_for_peers(int timeout_ms);
+    
+    MultikernelSystem& get_system() { return system; }
+    int get_node_id() const { return node_id; }
+    void print_latency_report();
+    
+private:
+    std::string socket_path(int node) const;
+    bool connect_peer(int node);
+    bool flush_peer(int node);
+    void deliver(const ClusterEnvelope& envelope);
+    void receiver_loop();
+    void flusher_loop();
+};
+
 #endif // MULTIKERNEL_H
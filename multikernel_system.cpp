@@ -1,6 +1,7 @@
 #include "multikernel.h"
 #include <iomanip>
 #include <climits>
+#include <algorithm>
 
 // ============================================================================
 // MULTIKERNEL SYSTEM IMPLEMENTATION
@@ -13,9 +14,20 @@ MultikernelSystem::MultikernelSystem() {
         cores.push_back(std::make_unique<CoreKernel>(i));
     }
     
+    // Shard coordination: each node owns a contiguous block of cores
+    nodes.reserve(NUM_NODES);
+    for (int n = 0; n < NUM_NODES; n++) {
+        std::vector<CoreKernel*> node_cores;
+        for (int i = n * CORES_PER_NODE; i < (n + 1) * CORES_PER_NODE; i++) {
+            node_cores.push_back(cores[i].get());
+        }
+        nodes.push_back(std::make_unique<NodeCoordinator>(n, std::move(node_cores)));
+    }
+    
     std::cout << "==================================================" << std::endl;
     std::cout << "  MULTIKERNEL OPERATING SYSTEM INITIALIZED" << std::endl;
-    std::cout << "  Cores: " << NUM_CORES << std::endl;
+    std::cout << "  Cores: " << NUM_CORES << " (" << NUM_NODES << " nodes x "
+              << CORES_PER_NODE << ")" << std::endl;
     std::cout << "  Message Queue Size: " << MESSAGE_QUEUE_SIZE << std::endl;
     std::cout << "  Max Processes: " << MAX_PROCESSES << std::endl;
     std::cout << "==================================================" << std::endl;
@@ -33,15 +45,23 @@ void MultikernelSystem::start() {
     
     system_running = true;
     
-    // Create vector of core pointers for inter-core communication
-    std::vector<CoreKernel*> core_ptrs;
+    start_time = std::chrono::steady_clock::now();
+    
+    // Create vector of core pointers for inter-core communication. It is a
+    // member so the cores' routing table outlives this call.
+    core_ptrs.clear();
     for (auto& core : cores) {
         core_ptrs.push_back(core.get());
     }
     
     // Start all cores
     for (auto& core : cores) {
-        core->start(&core_ptrs);
+        core->start(&core_ptrs, interconnect.get(), &topics, &processes, &names);
+    }
+    
+    // Start draining client submission rings
+    for (auto& node : nodes) {
+        node->start_ingestion();
     }
     
     std::cout << "\n[SYSTEM] All cores started successfully" << std::endl;
@@ -54,6 +74,11 @@ void MultikernelSystem::shutdown() {
     
     std::cout << "\n[SYSTEM] Initiating shutdown..." << std::endl;
     
+    // Stop ingesting new client work before the cores go away
+    for (auto& node : nodes) {
+        node->stop_ingestion();
+    }
+    
     // Send shutdown messages to all cores
     Message shutdown_msg;
     shutdown_msg.type = MSG_SHUTDOWN;
@@ -73,6 +98,24 @@ void MultikernelSystem::shutdown() {
     std::cout << "[SYSTEM] Shutdown complete" << std::endl;
 }
 
+void MultikernelSystem::set_interconnect_model(const InterconnectTopology& topology) {
+    if (system_running) {
+        std::cerr << "[SYSTEM] Interconnect model must be set before start()" << std::endl;
+        return;
+    }
+    
+    interconnect = std::make_unique<InterconnectModel>(topology);
+    std::cout << "[SYSTEM] Interconnect model: " << topology.sockets << " sockets x "
+              << topology.cores_per_socket << " cores, remote penalty "
+              << topology.remote_penalty << "x" << std::endl;
+}
+
+void MultikernelSystem::set_coalescing(MessageType type, int max_delay_us, int max_batch) {
+    for (auto& core : cores) {
+        core->set_coalescing(type, max_delay_us, max_batch);
+    }
+}
+
 // ============================================================================
 // PROCESS MANAGEMENT WITH LOAD BALANCING
 // ============================================================================
@@ -83,11 +126,31 @@ int MultikernelSystem::create_process(int priority) {
         return -1;
     }
     
-    // Find least loaded core (NUMA-aware load balancing)
-    int target_core = get_least_loaded_core();
+    // Place locally on the caller's home node (NUMA-aware load balancing)
+    int home = get_home_node();
+    int target_core = -1;
+    int pid = nodes[home]->create_process(priority, target_core);
     
-    // Create process on that core
-    int pid = cores[target_core]->create_process(priority);
+    if (pid < 0) {
+        // Home node saturated: escalate to the least loaded other node
+        std::lock_guard<std::mutex> lock(escalation_mutex);
+        escalations++;
+        
+        int best_node = home;
+        int best_load = nodes[home]->get_total_load();
+        for (int n = 0; n < NUM_NODES; n++) {
+            if (n != home && !nodes[n]->is_saturated() &&
+                nodes[n]->get_total_load() < best_load) {
+                best_node = n;
+                best_load = nodes[n]->get_total_load();
+            }
+        }
+        
+        std::cout << "[SYSTEM] Node " << home << " saturated, escalating to Node "
+                  << best_node << std::endl;
+        
+        pid = nodes[best_node]->create_process(priority, target_core, true);
+    }
     
     std::cout << "[SYSTEM] Process " << pid << " assigned to Core " 
               << target_core << " (load=" << cores[target_core]->get_load() 
@@ -96,6 +159,76 @@ int MultikernelSystem::create_process(int priority) {
     return pid;
 }
 
+void MultikernelSystem::create_process_batch(const std::vector<int>& priorities,
+                                             std::vector<int>& pids) {
+    pids.assign(priorities.size(), -1);
+    
+    if (!system_running) {
+        std::cerr << "[SYSTEM] Cannot create processes: system not running" << std::endl;
+        return;
+    }
+    
+    // Split the batch across nodes by their projected load; each node then
+    // places its share on its own cores under its own lock
+    std::vector<int> projected(NUM_NODES);
+    for (int n = 0; n < NUM_NODES; n++) {
+        projected[n] = nodes[n]->get_total_load();
+    }
+    
+    std::vector<std::vector<size_t>> assigned(NUM_NODES);
+    for (size_t k = 0; k < priorities.size(); k++) {
+        int best = static_cast<int>(
+            std::min_element(projected.begin(), projected.end()) - projected.begin());
+        assigned[best].push_back(k);
+        projected[best]++;
+    }
+    
+    int nodes_used = 0;
+    for (int n = 0; n < NUM_NODES; n++) {
+        if (assigned[n].empty()) continue;
+        
+        std::vector<int> node_priorities;
+        for (size_t k : assigned[n]) {
+            node_priorities.push_back(priorities[k]);
+        }
+        
+        std::vector<int> node_pids;
+        nodes[n]->create_process_batch(node_priorities, node_pids);
+        for (size_t j = 0; j < assigned[n].size(); j++) {
+            pids[assigned[n][j]] = node_pids[j];
+        }
+        nodes_used++;
+    }
+    
+    std::cout << "[SYSTEM] Batched " << priorities.size() << " creates across "
+              << nodes_used << " nodes" << std::endl;
+}
+
+int MultikernelSystem::get_home_node() const {
+    // Threads stick to one node, so concurrent callers spread across nodes
+    // without sharing a counter
+    return std::hash<std::thread::id>{}(std::this_thread::get_id()) % NUM_NODES;
+}
+
+ClientQueues* MultikernelSystem::register_client() {
+    std::lock_guard<std::mutex> lock(clients_mutex);
+    
+    // Spread clients across nodes; each node drains only its own clients
+    int id = static_cast<int>(clients.size());
+    NodeCoordinator* node = nodes[id % NUM_NODES].get();
+    clients.push_back(std::make_unique<ClientQueues>(id, node));
+    node->attach_client(clients.back().get());
+    
+    return clients.back().get();
+}
+
+bool MultikernelSystem::deliver_message(const Message& msg) {
+    if (!system_running || msg.dest_core < 0 || msg.dest_core >= NUM_CORES) {
+        return false;
+    }
+    return cores[msg.dest_core]->deliver_external(msg);
+}
+
 bool MultikernelSystem::migrate_process(int pid, int source_core, int target_core) {
     if (source_core < 0 || source_core >= NUM_CORES ||
         target_core < 0 || target_core >= NUM_CORES) {
@@ -111,16 +244,15 @@ bool MultikernelSystem::migrate_process(int pid, int source_core, int target_cor
 // ============================================================================
 
 int MultikernelSystem::get_least_loaded_core() {
-    std::lock_guard<std::mutex> lock(load_balancer_mutex);
-    
     int min_load = INT_MAX;
     int best_core = 0;
     
-    for (int i = 0; i < NUM_CORES; i++) {
-        int load = cores[i]->get_load();
+    for (auto& node : nodes) {
+        int core = node->get_least_loaded_core();
+        int load = cores[core]->get_load();
         if (load < min_load) {
             min_load = load;
-            best_core = i;
+            best_core = core;
         }
     }
     
@@ -128,34 +260,23 @@ int MultikernelSystem::get_least_loaded_core() {
 }
 
 void MultikernelSystem::balance_load() {
-    std::lock_guard<std::mutex> lock(load_balancer_mutex);
-    
-    // Calculate average load
-    int total_load = 0;
-    for (const auto& core : cores) {
-        total_load += core->get_load();
+    // Balance within each node; nodes do not contend with each other
+    for (auto& node : nodes) {
+        node->balance_load();
     }
     
-    if (total_load == 0) return;
-    
-    float avg_load = static_cast<float>(total_load) / NUM_CORES;
-    
-    std::cout << "\n[LOAD BALANCER] Average load: " << avg_load << std::endl;
-    
-    // Find overloaded and underloaded cores
-    for (int i = 0; i < NUM_CORES; i++) {
-        int load = cores[i]->get_load();
+    // Cross-node escalation only when a node is saturated
+    for (auto& node : nodes) {
+        if (!node->is_saturated()) continue;
         
-        if (load > avg_load * 1.5) { // Core is overloaded
-            std::cout << "[LOAD BALANCER] Core " << i << " overloaded (load=" 
-                      << load << ")" << std::endl;
-            
-            // Find underloaded core
-            int target = get_least_loaded_core();
-            if (target != i && cores[target]->get_load() < avg_load * 0.7) {
-                std::cout << "[LOAD BALANCER] Would migrate process from Core " 
-                          << i << " to Core " << target << std::endl;
-                // In a real implementation, we'd migrate a process here
+        std::lock_guard<std::mutex> lock(escalation_mutex);
+        for (auto& other : nodes) {
+            if (other != node && !other->is_saturated()) {
+                std::cout << "[LOAD BALANCER] Node " << node->get_node_id()
+                          << " saturated, would migrate to Core "
+                          << other->get_least_loaded_core() << " on Node "
+                          << other->get_node_id() << std::endl;
+                break;
             }
         }
     }
@@ -179,10 +300,84 @@ void MultikernelSystem::print_statistics() {
         std::cout << "  Current Load:      " << stats.current_load << " processes" << std::endl;
         std::cout << "  Messages Sent:     " << stats.messages_sent << std::endl;
         std::cout << "  Messages Received: " << stats.messages_received << std::endl;
+        std::cout << "  Self Messages:     " << stats.self_messages << std::endl;
+        std::cout << "  Refused Sends:     " << stats.messages_refused << std::endl;
+        std::cout << "  Expired Dropped:   " << stats.messages_expired << std::endl;
+        uint64_t busy_us = stats.message_time_us + stats.process_time_us;
+        if (busy_us > 0) {
+            std::cout << "  Time Split:        " << (100 * stats.message_time_us / busy_us)
+                      << "% messages / " << (100 * stats.process_time_us / busy_us)
+                      << "% processes" << std::endl;
+        }
+        std::cout << "  Message Budget:    " << stats.message_budget << " per pass (cut short "
+                  << stats.budget_exhaustions << " times)" << std::endl;
+        if (stats.urgent_messages > 0) {
+            std::cout << "  Urgent Messages:   " << stats.urgent_messages << " (avg "
+                      << stats.urgent_latency_us / stats.urgent_messages << " us, "
+                      << stats.preemptions << " preemptions)" << std::endl;
+        }
+        if (stats.outbox_flushes > 0) {
+            std::cout << "  Outbox:            " << stats.outbox_staged << " staged in "
+                      << stats.outbox_flushes << " flushes, " << stats.batched_pushes
+                      << " batched pushes, " << stats.outbox_refused << " refused" << std::endl;
+        }
+        if (stats.migrations_refused > 0) {
+            std::cout << "  Migrations Refused: " << stats.migrations_refused << std::endl;
+        }
+        if (stats.coalesced_units > 0) {
+            std::cout << "  Coalesced:         " << stats.coalesced_messages << " sends in "
+                      << stats.coalesced_units << " units, " << stats.coalesced_refused
+                      << " refused" << std::endl;
+        }
+        if (stats.topic_published > 0 || stats.topic_delivered > 0) {
+            std::cout << "  Topics:            " << stats.topic_published << " published ("
+                      << stats.topic_fanout << " copies), " << stats.topic_delivered
+                      << " delivered, " << stats.topic_dropped << " dropped" << std::endl;
+        }
+        if (stats.channel_grows > 0 || stats.channel_shrinks > 0 || stats.channel_grows_denied > 0) {
+            std::cout << "  Channel Resizes:   " << stats.channel_grows << " grown, "
+                      << stats.channel_shrinks << " shrunk, " << stats.channel_grows_denied
+                      << " denied by budget" << std::endl;
+        }
+        if (stats.timers_set > 0) {
+            std::cout << "  Timers:            " << stats.timers_set << " set, "
+                      << stats.timers_fired << " fired, " << stats.timers_cancelled
+                      << " cancelled";
+            if (stats.timers_fired > 0) {
+                std::cout << ", " << stats.timer_lateness_us / static_cast<int64_t>(stats.timers_fired)
+                          << " us avg late";
+            }
+            std::cout << std::endl;
+        }
+        if (stats.mail_sent > 0 || stats.mail_delivered > 0) {
+            std::cout << "  Process Mail:      " << stats.mail_sent << " sent ("
+                      << stats.mail_local << " same-core), " << stats.mail_delivered
+                      << " delivered, " << stats.mail_forwarded << " forwarded, "
+                      << stats.mail_dropped << " dropped" << std::endl;
+        }
+        if (stats.name_cache_hits > 0 || stats.name_cache_misses > 0) {
+            std::cout << "  Name Cache:        " << stats.name_cache_hits << " hits, "
+                      << stats.name_cache_misses << " misses, " << stats.name_updates
+                      << " updates" << std::endl;
+        }
+        if (stats.wire_messages > 0) {
+            std::cout << "  Wire Bytes:        " << stats.wire_bytes << " in "
+                      << stats.wire_messages << " messages ("
+                      << stats.wire_bytes / stats.wire_messages << " avg, "
+                      << sizeof(Message) << " fixed)" << std::endl;
+        }
+        std::cout << "  Heartbeats:        " << stats.heartbeats_sent << " sent, "
+                  << stats.peer_updates_piggybacked << " peer updates piggybacked" << std::endl;
+        std::cout << "  Wakeups:           " << stats.wakeups_sent << " sent, "
+                  << stats.wakeups_suppressed << " suppressed" << std::endl;
         std::cout << "  Processes Executed:" << stats.processes_executed << std::endl;
         std::cout << "  Context Switches:  " << stats.context_switches << std::endl;
         std::cout << "  Avg Msg Latency:   " << stats.avg_message_latency_us.load() 
                   << " μs" << std::endl;
+        std::cout << "  Open Channels:     " << stats.open_channels
+                  << " (" << stats.channel_bytes / 1024 << " KiB)" << std::endl;
+        std::cout << "  Memory Backing:    " << page_backing_name(cores[i]->get_page_backing())
+                  << " (" << cores[i]->get_arena_bytes() / 1024 << " KiB mapped)" << std::endl;
     }
     
     // System-wide statistics
@@ -205,6 +400,20 @@ void MultikernelSystem::print_statistics() {
     std::cout << "  Total Processes Executed:" << total_processes << std::endl;
     std::cout << "  Total Context Switches:  " << total_context_switches << std::endl;
     
+    for (const auto& node : nodes) {
+        std::cout << "  Node " << node->get_node_id() << " Load:             "
+                  << node->get_total_load()
+                  << (node->is_saturated() ? " (saturated)" : "") << std::endl;
+        std::cout << "  Node " << node->get_node_id() << " Ingested:         "
+                  << node->get_entries_ingested() << " entries in "
+                  << node->get_ingest_batches() << " batches" << std::endl;
+    }
+    std::cout << "  Cross-Node Escalations:  " << escalations << std::endl;
+    
+    if (interconnect) {
+        interconnect->print_statistics();
+    }
+    
     // Calculate message throughput
     if (total_messages_sent > 0) {
         float message_efficiency = (static_cast<float>(total_messages_received) / 
@@ -214,4 +423,47 @@ void MultikernelSystem::print_statistics() {
     }
     
     std::cout << "========================================================\n" << std::endl;
+    
+    sample_channel_usage();
+}
+
+// ============================================================================
+// CHANNEL USAGE - Interconnect memory over time
+// ============================================================================
+
+void MultikernelSystem::sample_channel_usage() {
+    ChannelSample sample;
+    sample.when = std::chrono::steady_clock::now();
+    sample.open_channels = 0;
+    sample.channel_bytes = 0;
+    
+    for (const auto& core : cores) {
+        auto stats = core->get_statistics();
+        sample.open_channels += stats.open_channels;
+        sample.channel_bytes += stats.channel_bytes;
+    }
+    
+    channel_history.push_back(sample);
+}
+
+void MultikernelSystem::print_channel_report() {
+    sample_channel_usage();
+    
+    // Memory an eager all-pairs interconnect would have needed up front
+    uint64_t eager_bytes = static_cast<uint64_t>(NUM_CORES) * NUM_CORES *
+                           channel_slots(CHANNEL_CAPACITY) * CHANNEL_SLOT_SIZE;
+    
+    std::cout << "\n--- Channel Usage Over Time ---" << std::endl;
+    std::cout << "  Time(ms)   Channels   Memory(KiB)" << std::endl;
+    for (const auto& sample : channel_history) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            sample.when - start_time).count();
+        std::cout << "  " << std::setw(8) << elapsed
+                  << "   " << std::setw(8) << sample.open_channels
+                  << "   " << std::setw(11) << sample.channel_bytes / 1024 << std::endl;
+    }
+    std::cout << "  Eager N^2 allocation would hold " << eager_bytes / 1024
+              << " KiB" << std::endl;
+    std::cout << "  Ring memory budget: " << channel_memory_in_use() / 1024 << " of "
+              << channel_memory_budget() / 1024 << " KiB in use" << std::endl;
 }
@@ -0,0 +1,68 @@
+#include "multikernel.h"
+
+// ============================================================================
+// NAME SERVICE IMPLEMENTATION
+// ============================================================================
+
+NameService::Change NameService::bind(const std::string& name, ServiceAddress address,
+                                      int owner_pid) {
+    std::lock_guard<std::mutex> lock(names_mutex);
+    
+    Entry& entry = entries[name];
+    entry.address = address;
+    entry.owner_pid = owner_pid;
+    entry.generation = ++generation;
+    return {name, address, entry.generation};
+}
+
+bool NameService::unbind(const std::string& name, Change& change) {
+    std::lock_guard<std::mutex> lock(names_mutex);
+    
+    auto it = entries.find(name);
+    if (it == entries.end()) return false;
+    
+    entries.erase(it);
+    change = {name, ServiceAddress(), ++generation};
+    return true;
+}
+
+bool NameService::lookup(const std::string& name, ServiceAddress& address,
+                         uint64_t& entry_generation) const {
+    std::lock_guard<std::mutex> lock(names_mutex);
+    
+    auto it = entries.find(name);
+    if (it == entries.end()) return false;
+    
+    address = it->second.address;
+    entry_generation = it->second.generation;
+    return true;
+}
+
+std::vector<NameService::Change> NameService::rehome(int owner_pid, int core) {
+    std::lock_guard<std::mutex> lock(names_mutex);
+    
+    std::vector<Change> changes;
+    for (auto& [name, entry] : entries) {
+        if (entry.owner_pid != owner_pid || entry.address.core == core) continue;
+        
+        entry.address.core = core;
+        entry.generation = ++generation;
+        changes.push_back({name, entry.address, entry.generation});
+    }
+    return changes;
+}
+
+std::vector<NameService::Change> NameService::release(int owner_pid) {
+    std::lock_guard<std::mutex> lock(names_mutex);
+    
+    std::vector<Change> changes;
+    for (auto it = entries.begin(); it != entries.end(); ) {
+        if (it->second.owner_pid == owner_pid) {
+            changes.push_back({it->first, ServiceAddress(), ++generation});
+            it = entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return changes;
+}
@@ -0,0 +1,281 @@
+#include "multikernel.h"
+#include <climits>
+#include <algorithm>
+
+// ============================================================================
+// NODE COORDINATOR IMPLEMENTATION
+// ============================================================================
+
+NodeCoordinator::NodeCoordinator(int id, std::vector<CoreKernel*> cores)
+    : node_id(id), node_cores(std::move(cores)) {}
+
+NodeCoordinator::~NodeCoordinator() {
+    stop_ingestion();
+}
+
+bool NodeCoordinator::owns_core(int core) const {
+    for (auto* c : node_cores) {
+        if (c->get_core_id() == core) return true;
+    }
+    return false;
+}
+
+CoreKernel* NodeCoordinator::find_core(int core) {
+    for (auto* c : node_cores) {
+        if (c->get_core_id() == core) return c;
+    }
+    return nullptr;
+}
+
+int NodeCoordinator::least_loaded_index() const {
+    int min_load = INT_MAX;
+    int best = 0;
+
+    for (size_t i = 0; i < node_cores.size(); i++) {
+        int load = node_cores[i]->get_load();
+        if (load < min_load) {
+            min_load = load;
+            best = static_cast<int>(i);
+        }
+    }
+
+    return best;
+}
+
+int NodeCoordinator::get_least_loaded_core() {
+    std::lock_guard<std::mutex> lock(node_mutex);
+    return node_cores[least_loaded_index()]->get_core_id();
+}
+
+int NodeCoordinator::get_total_load() const {
+    int total = 0;
+    for (auto* core : node_cores) {
+        total += core->get_load();
+    }
+    return total;
+}
+
+bool NodeCoordinator::is_saturated() const {
+    return node_cores[least_loaded_index()]->get_load() >= NODE_SATURATION_LOAD;
+}
+
+// ============================================================================
+// LOCAL PLACEMENT
+// ============================================================================
+
+int NodeCoordinator::create_process(int priority, int& placed_core, bool force) {
+    // Holding the node lock across the pick and the create keeps concurrent
+    // callers from all landing on the same "least loaded" core
+    std::lock_guard<std::mutex> lock(node_mutex);
+
+    CoreKernel* target = node_cores[least_loaded_index()];
+    if (!force && target->get_load() >= NODE_SATURATION_LOAD) {
+        return -1;
+    }
+
+    placed_core = target->get_core_id();
+    return target->create_process(priority);
+}
+
+void NodeCoordinator::create_process_batch(const std::vector<int>& priorities,
+                                           std::vector<int>& pids) {
+    std::lock_guard<std::mutex> lock(node_mutex);
+    
+    pids.assign(priorities.size(), -1);
+    
+    // Place the whole batch against projected loads, then one create per core
+    std::vector<int> projected;
+    for (auto* core : node_cores) {
+        projected.push_back(core->get_load());
+    }
+    
+    std::vector<std::vector<size_t>> assigned(node_cores.size());
+    for (size_t k = 0; k < priorities.size(); k++) {
+        size_t best = std::min_element(projected.begin(), projected.end()) - projected.begin();
+        assigned[best].push_back(k);
+        projected[best]++;
+    }
+    
+    for (size_t i = 0; i < node_cores.size(); i++) {
+        if (assigned[i].empty()) continue;
+        
+        std::vector<int> core_priorities;
+        for (size_t k : assigned[i]) {
+            core_priorities.push_back(priorities[k]);
+        }
+        
+        std::vector<int> core_pids;
+        node_cores[i]->create_process_batch(core_priorities, core_pids);
+        for (size_t j = 0; j < assigned[i].size(); j++) {
+            pids[assigned[i][j]] = core_pids[j];
+        }
+    }
+}
+
+// ============================================================================
+// LOCAL LOAD BALANCING
+// ============================================================================
+
+void NodeCoordinator::balance_load() {
+    std::lock_guard<std::mutex> lock(node_mutex);
+
+    // Calculate average load within this node
+    int total_load = get_total_load();
+    if (total_load == 0) return;
+
+    float avg_load = static_cast<float>(total_load) / node_cores.size();
+
+    std::cout << "\n[LOAD BALANCER][Node " << node_id << "] Average load: "
+              << avg_load << std::endl;
+
+    // Find overloaded and underloaded cores
+    for (auto* core : node_cores) {
+        int load = core->get_load();
+
+        if (load > avg_load * 1.5) { // Core is overloaded
+            std::cout << "[LOAD BALANCER][Node " << node_id << "] Core "
+                      << core->get_core_id() << " overloaded (load="
+                      << load << ")" << std::endl;
+
+            // Find underloaded core on the same node
+            CoreKernel* target = node_cores[least_loaded_index()];
+            if (target != core && target->get_load() < avg_load * 0.7) {
+                std::cout << "[LOAD BALANCER][Node " << node_id
+                          << "] Would migrate process from Core "
+                          << core->get_core_id() << " to Core "
+                          << target->get_core_id() << std::endl;
+                // In a real implementation, we'd migrate a process here
+            }
+        }
+    }
+}
+
+// ============================================================================
+// CLIENT SUBMISSION RINGS
+// ============================================================================
+
+bool ClientQueues::submit(const SubmissionEntry& entry) {
+    if (!sq.push(entry)) {
+        return false;
+    }
+    node->ring_doorbell();
+    return true;
+}
+
+int ClientQueues::reap(CompletionEntry* out, int max_entries) {
+    int reaped = 0;
+    while (reaped < max_entries && cq.pop(out[reaped])) {
+        reaped++;
+    }
+    return reaped;
+}
+
+void NodeCoordinator::attach_client(ClientQueues* client) {
+    std::lock_guard<std::mutex> lock(clients_mutex);
+    clients.push_back(client);
+}
+
+void NodeCoordinator::ring_doorbell() {
+    // Only pay for a wakeup when the drainer is actually parked
+    if (ingest_sleeping.load(std::memory_order_acquire)) {
+        { std::lock_guard<std::mutex> lock(ingest_mutex); }
+        ingest_cv.notify_one();
+    }
+}
+
+void NodeCoordinator::start_ingestion() {
+    if (ingesting) return;
+    
+    ingesting = true;
+    ingest_thread = std::thread(&NodeCoordinator::ingest_loop, this);
+}
+
+void NodeCoordinator::stop_ingestion() {
+    if (!ingest_thread.joinable()) return;
+    
+    ingesting = false;
+    {
+        std::lock_guard<std::mutex> lock(ingest_mutex);
+        ingest_cv.notify_all();
+    }
+    ingest_thread.join();
+}
+
+void NodeCoordinator::ingest_loop() {
+    while (ingesting) {
+        int drained = 0;
+        {
+            std::lock_guard<std::mutex> lock(clients_mutex);
+            for (auto* client : clients) {
+                drained += drain_client(client);
+            }
+        }
+        
+        if (drained > 0) continue;
+        
+        // Nothing queued: park until a client rings the doorbell. The short
+        // timeout covers a submit that raced with setting the flag.
+        std::unique_lock<std::mutex> lock(ingest_mutex);
+        ingest_sleeping.store(true, std::memory_order_release);
+        ingest_cv.wait_for(lock, std::chrono::milliseconds(1));
+        ingest_sleeping.store(false, std::memory_order_release);
+    }
+}
+
+int NodeCoordinator::drain_client(ClientQueues* client) {
+    // Never take more than the completion ring can absorb
+    int budget = static_cast<int>(std::min<size_t>(INGEST_BATCH, client->cq.free_space()));
+    
+    std::vector<SubmissionEntry> batch;
+    SubmissionEntry entry;
+    while (static_cast<int>(batch.size()) < budget && client->sq.pop(entry)) {
+        batch.push_back(entry);
+    }
+    if (batch.empty()) return 0;
+    
+    // Creates in the batch share one placement decision
+    std::vector<int> priorities;
+    for (const auto& e : batch) {
+        if (e.op == SUBMIT_CREATE) priorities.push_back(e.priority);
+    }
+    std::vector<int> pids;
+    if (!priorities.empty()) {
+        create_process_batch(priorities, pids);
+    }
+    
+    bool balanced = false;
+    size_t next_pid = 0;
+    for (const auto& e : batch) {
+        CompletionEntry done;
+        done.user_data = e.user_data;
+        
+        switch (e.op) {
+            case SUBMIT_CREATE:
+                done.result = pids[next_pid++];
+                break;
+                
+            case SUBMIT_TERMINATE: {
+                CoreKernel* core = find_core(e.target_core);
+                if (core) {
+                    core->terminate_process(e.pid);
+                    done.result = 0;
+                }
+                break;
+            }
+            
+            case SUBMIT_BALANCE:
+                if (!balanced) {
+                    balance_load();
+                    balanced = true;
+                }
+                done.result = 0;
+                break;
+        }
+        
+        client->cq.push(done);
+    }
+    
+    entries_ingested += batch.size();
+    ingest_batches++;
+    return static_cast<int>(batch.size());
+}
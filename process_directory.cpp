@@ -0,0 +1,41 @@
+#include "multikernel.h"
+
+// ============================================================================
+// PROCESS DIRECTORY IMPLEMENTATION
+// ============================================================================
+
+void ProcessDirectory::place(int pid, int core) {
+    Shard& shard = shard_of(pid);
+    std::lock_guard<std::mutex> lock(shard.shard_mutex);
+    shard.cores[pid] = core;
+}
+
+void ProcessDirectory::remove(int pid, int core) {
+    Shard& shard = shard_of(pid);
+    std::lock_guard<std::mutex> lock(shard.shard_mutex);
+    
+    // A migration may already have re-placed it; that entry is not ours
+    auto it = shard.cores.find(pid);
+    if (it != shard.cores.end() && it->second == core) {
+        shard.cores.erase(it);
+    }
+}
+
+bool ProcessDirectory::move(int pid, int from, int to) {
+    Shard& shard = shard_of(pid);
+    std::lock_guard<std::mutex> lock(shard.shard_mutex);
+    
+    // Released while it was on its way: do not bring it back
+    auto it = shard.cores.find(pid);
+    if (it == shard.cores.end() || it->second != from) return false;
+    it->second = to;
+    return true;
+}
+
+int ProcessDirectory::core_of(int pid) const {
+    const Shard& shard = shard_of(pid);
+    std::lock_guard<std::mutex> lock(shard.shard_mutex);
+    
+    auto it = shard.cores.find(pid);
+    return it != shard.cores.end() ? it->second : -1;
+}
@@ -1,9 +1,53 @@
 #include "multikernel.h"
 #include <iostream>
+#include <algorithm>
 #include <vector>
+#include <mutex>
 #include <atomic>
 #include <chrono>
 #include <cassert>
+#include <cstring>
+#include <map>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Process-wide hardware counter; inherit=1 folds in threads created after it
+// is opened once they exit, so read it after the system has shut down
+class PerfCounter {
+private:
+    int fd = -1;
+
+public:
+    PerfCounter(uint32_t type, uint64_t config) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+    ~PerfCounter() { if (fd >= 0) close(fd); }
+
+    bool valid() const { return fd >= 0; }
+    void start() {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    uint64_t stop() {
+        uint64_t value = 0;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd, &value, sizeof(value)) != sizeof(value)) return 0;
+        return value;
+    }
+};
 
 class MultikernelTester {
 private:
@@ -53,6 +97,1279 @@ public:
         std::cout << "Average Injection Latency: " << (latency.count() / 100.0) << " ms/task" << std::endl;
         std::cout << "Communication Overhead: " << (system.get_comm_overhead_pct()) << "%" << std::endl;
     }
+
+    // 4. SCALABILITY: Creation throughput with per-node coordinators
+    void test_creation_scaling() {
+        std::cout << "\n--- CREATION SCALING (per-node coordinators) ---" << std::endl;
+        const int per_thread = 50;
+
+        // Threads map to home nodes, so throughput should grow with NUM_NODES
+        for (int threads = 1; threads <= NUM_NODES * 2; threads *= 2) {
+            auto start = std::chrono::high_resolution_clock::now();
+
+            std::vector<std::thread> creators;
+            for (int t = 0; t < threads; ++t) {
+                creators.emplace_back([this]() {
+                    for (int j = 0; j < per_thread; ++j) system.create_process(5);
+                });
+            }
+            for (auto& t : creators) t.join();
+
+            auto end = std::chrono::high_resolution_clock::now();
+            std::chrono::duration<double> elapsed = end - start;
+
+            std::cout << threads << " creator thread(s): "
+                      << (threads * per_thread / elapsed.count()) << " creates/s" << std::endl;
+        }
+    }
+
+    // 5. PERFORMANCE: Flat-combining front end vs direct calls
+    void test_combining_throughput() {
+        std::cout << "\n--- CLIENT THROUGHPUT (direct vs combining) ---" << std::endl;
+        const int per_thread = 50;
+        CombiningFrontEnd front_end(system);
+
+        auto run = [&](int threads, bool combined) {
+            auto start = std::chrono::high_resolution_clock::now();
+            std::vector<std::thread> clients;
+            for (int t = 0; t < threads; ++t) {
+                clients.emplace_back([&]() {
+                    for (int j = 0; j < per_thread; ++j) {
+                        if (combined) front_end.create_process(5);
+                        else system.create_process(5);
+                    }
+                });
+            }
+            for (auto& t : clients) t.join();
+            std::chrono::duration<double> elapsed =
+                std::chrono::high_resolution_clock::now() - start;
+            return threads * per_thread / elapsed.count();
+        };
+
+        // Warm up first, so the 1-client run does not pay for opening channels
+        run(1, false);
+
+        double first_batch = 0.0, last_batch = 0.0;
+        for (int threads = 1; threads <= 16; threads *= 2) {
+            double direct = run(threads, false);
+            uint64_t passes = front_end.get_combine_passes();
+            uint64_t requests = front_end.get_combined_requests();
+            double combined = run(threads, true);
+            passes = front_end.get_combine_passes() - passes;
+            requests = front_end.get_combined_requests() - requests;
+            double batch = passes ? static_cast<double>(requests) / passes : 0.0;
+            if (threads == 1) first_batch = batch;
+            last_batch = batch;
+            std::cout << threads << " client(s): direct " << direct
+                      << " ops/s, combined " << combined << " ops/s, batch " << batch << std::endl;
+        }
+        std::cout << "Average combined batch: " << front_end.get_average_batch() << std::endl;
+        std::cout << "  -> Result: " << (last_batch > first_batch && last_batch > 1.0 ? "PASS" : "FAIL")
+                  << " (one combine pass serves more clients as they are added)" << std::endl;
+    }
+
+    // 6. PERFORMANCE: Per-client submission rings with batched ingestion
+    void test_submission_rings() {
+        std::cout << "\n--- INGESTION THROUGHPUT (submission rings) ---" << std::endl;
+        const int per_client = 200;
+
+        for (int num_clients = 1; num_clients <= 8; num_clients *= 2) {
+            std::vector<ClientQueues*> rings;
+            for (int c = 0; c < num_clients; ++c) rings.push_back(system.register_client());
+
+            auto start = std::chrono::high_resolution_clock::now();
+            std::vector<std::thread> producers;
+            for (auto* ring : rings) {
+                producers.emplace_back([ring]() {
+                    int submitted = 0, completed = 0;
+                    CompletionEntry done[32];
+                    while (completed < per_client) {
+                        SubmissionEntry entry;
+                        entry.user_data = submitted;
+                        if (submitted < per_client && ring->submit(entry)) submitted++;
+                        completed += ring->reap(done, 32);
+                    }
+                });
+            }
+            for (auto& t : producers) t.join();
+            std::chrono::duration<double> elapsed =
+                std::chrono::high_resolution_clock::now() - start;
+
+            std::cout << num_clients << " client(s): "
+                      << (num_clients * per_client / elapsed.count()) << " creates/s" << std::endl;
+        }
+    }
+
+    // 7. PERFORMANCE: dTLB misses with and without huge-page-backed rings/PCBs
+    // Builds its own systems, since the backing is chosen when memory is mapped
+    void test_hugepage_tlb() {
+        std::cout << "\n--- HUGE PAGES (all-to-all messaging + process churn) ---" << std::endl;
+        const int rounds = 20;
+        const int burst = 10;
+
+        for (bool huge : {false, true}) {
+            set_hugepages_enabled(huge);
+            PerfCounter dtlb(PERF_TYPE_HW_CACHE,
+                             PERF_COUNT_HW_CACHE_DTLB |
+                             (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                             (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+            if (dtlb.valid()) dtlb.start();
+
+            uint64_t messages = 0;
+            PageBacking backing = BACKING_NONE;
+            auto start = std::chrono::high_resolution_clock::now();
+            {
+                MultikernelSystem sys;
+                sys.start();
+                for (int r = 0; r < rounds; ++r) {
+                    for (int src = 0; src < NUM_CORES; ++src) {
+                        sys.create_process(5);
+                        for (int dst = 0; dst < NUM_CORES; ++dst) {
+                            if (dst == src) continue;
+                            for (int k = 0; k < burst; ++k) {
+                                Message msg;
+                                msg.source_core = src;
+                                msg.dest_core = dst;
+                                msg.type = MSG_HEARTBEAT;
+                                sys.get_core(src)->send_message(msg);
+                                messages++;
+                            }
+                        }
+                    }
+                    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+                }
+                backing = sys.get_core(0)->get_page_backing();
+                sys.shutdown();
+            }
+            std::chrono::duration<double, std::micro> elapsed =
+                std::chrono::high_resolution_clock::now() - start;
+
+            std::cout << (huge ? "Huge pages" : "4 KiB pages") << " ("
+                      << page_backing_name(backing) << "): ";
+            if (dtlb.valid()) std::cout << dtlb.stop() << " dTLB load misses, ";
+            else std::cout << "dTLB counter unavailable, ";
+            std::cout << (elapsed.count() / messages) << " us/message" << std::endl;
+        }
+        set_hugepages_enabled(true);
+    }
+
+    // 8. PERFORMANCE: Inbox contention against the CoreKernel layout
+    // Several cores hammer core 0's inbox while a reader drains it; the
+    // producer-written region should keep the worker's lines out of the fight
+    void test_layout_contention() {
+        std::cout << "\n--- INBOX CONTENTION (cache-line layout) ---" << std::endl;
+        std::cout << "sizeof(CoreKernel) = " << sizeof(CoreKernel)
+                  << ", alignof = " << alignof(CoreKernel) << std::endl;
+
+        const int producers = NUM_CORES - 1;
+        const int per_producer = 2000;
+        const int burst = 50;
+        CoreKernel* receiver = system.get_core(0);
+
+        // Establish the channels first so the run measures the steady state
+        for (int p = 1; p <= producers; ++p) {
+            Message msg;
+            msg.source_core = p;
+            msg.dest_core = 0;
+            system.get_core(p)->send_message(msg);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        PerfCounter misses(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        if (misses.valid()) misses.start();
+
+        std::atomic<bool> done{false};
+        std::atomic<uint64_t> drained{0};
+        auto start = std::chrono::high_resolution_clock::now();
+
+        std::thread reader([&]() {
+            Message msg;
+            while (!done) {
+                if (receiver->receive_message(msg, 1)) drained++;
+            }
+        });
+
+        std::vector<std::thread> senders;
+        for (int p = 1; p <= producers; ++p) {
+            senders.emplace_back([&, p]() {
+                CoreKernel* sender = system.get_core(p);
+                for (int sent = 0; sent < per_producer; sent += burst) {
+                    // Stay within the channel so nothing is dropped
+                    uint64_t target = receiver->get_statistics().messages_received + burst;
+                    for (int k = 0; k < burst; ++k) {
+                        Message msg;
+                        msg.source_core = p;
+                        msg.dest_core = 0;
+                        sender->send_message(msg);
+                    }
+                    while (receiver->get_statistics().messages_received < target) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (auto& t : senders) t.join();
+        done = true;
+        reader.join();
+
+        std::chrono::duration<double> elapsed =
+            std::chrono::high_resolution_clock::now() - start;
+        uint64_t total = static_cast<uint64_t>(producers) * per_producer;
+
+        std::cout << producers << " producers: " << (total / elapsed.count()) << " msgs/s";
+        if (misses.valid()) std::cout << ", " << (misses.stop() / static_cast<double>(total))
+                                      << " cache misses/msg";
+        std::cout << std::endl;
+    }
+
+    // 9. WAKEUP SUPPRESSION: Notifies per message under heavy traffic
+    void test_wakeup_suppression() {
+        std::cout << "\n--- WAKEUP SUPPRESSION (heavy traffic into one core) ---" << std::endl;
+
+        const int producers = NUM_CORES - 1;
+        const int per_producer = 5000;
+        const int burst = 50;
+        CoreKernel* receiver = system.get_core(0);
+
+        for (int p = 1; p <= producers; ++p) {
+            Message msg;
+            msg.source_core = p;
+            msg.dest_core = 0;
+            system.get_core(p)->send_message(msg);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        // Wakeups are counted by the cores that send them
+        auto wakeups = [&]() {
+            uint64_t sent = 0, suppressed = 0;
+            for (int p = 1; p <= producers; ++p) {
+                CoreStatistics st = system.get_core(p)->get_statistics();
+                sent += st.wakeups_sent;
+                suppressed += st.wakeups_suppressed;
+            }
+            return std::make_pair(sent, suppressed);
+        };
+
+        auto before = wakeups();
+        rusage usage_before;
+        getrusage(RUSAGE_SELF, &usage_before);
+        auto start = std::chrono::high_resolution_clock::now();
+
+        // The receiver's own worker drains; it parks whenever it runs dry
+        std::vector<std::thread> senders;
+        for (int p = 1; p <= producers; ++p) {
+            senders.emplace_back([&, p]() {
+                CoreKernel* sender = system.get_core(p);
+                for (int sent = 0; sent < per_producer; sent += burst) {
+                    uint64_t target = receiver->get_statistics().messages_received + burst;
+                    for (int k = 0; k < burst; ++k) {
+                        Message msg;
+                        msg.source_core = p;
+                        msg.dest_core = 0;
+                        sender->send_message(msg);
+                    }
+                    while (receiver->get_statistics().messages_received < target) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (auto& t : senders) t.join();
+
+        std::chrono::duration<double> elapsed =
+            std::chrono::high_resolution_clock::now() - start;
+        rusage usage_after;
+        getrusage(RUSAGE_SELF, &usage_after);
+        auto after = wakeups();
+
+        double total = static_cast<double>(producers) * per_producer;
+        uint64_t sent = after.first - before.first;
+        uint64_t suppressed = after.second - before.second;
+        long switches = usage_after.ru_nvcsw - usage_before.ru_nvcsw;
+
+        std::cout << producers << " producers: " << (total / elapsed.count()) << " msgs/s" << std::endl;
+        std::cout << "  notify calls/msg:     " << (sent / total)
+                  << " (" << suppressed << " suppressed)" << std::endl;
+        std::cout << "  voluntary switches/msg: " << (switches / total) << std::endl;
+    }
+
+    // 10. FAIRNESS: Quiet senders' latency while another core floods, and
+    // each backlogged source's share of the receiver's worker
+    void test_fair_draining() {
+        std::cout << "\n--- FAIR DRAINING (one flooding sender, six quiet ones) ---" << std::endl;
+        CoreKernel* receiver = system.get_core(0);
+
+        // Measured where the worker's DRR serves: a topic handler on core 0
+        std::atomic<bool> sampling{false};
+        std::vector<double> latencies_us;
+        std::mutex latencies_mutex;
+        std::vector<int>* recording = nullptr;
+        std::atomic<uint64_t> handled{0};
+        int topic = receiver->subscribe("fairness", [&](const Message& msg) {
+            if (msg.source_core < 0 || msg.source_core >= NUM_CORES) return;
+            handled++;
+            {
+                std::lock_guard<std::mutex> lock(latencies_mutex);
+                if (recording) recording->push_back(msg.source_core);
+            }
+            if (!sampling || msg.source_core == 1) return;
+            std::chrono::duration<double, std::micro> latency =
+                std::chrono::steady_clock::now() - msg.timestamp;
+            std::lock_guard<std::mutex> lock(latencies_mutex);
+            latencies_us.push_back(latency.count());
+        });
+
+        // A publish that was pushed back shows up in the sender's outbox_refused
+        std::atomic<uint64_t> accepted{0};
+        auto publish = [&](int core) {
+            CoreKernel* sender = system.get_core(core);
+            uint64_t refused = sender->get_statistics().outbox_refused;
+            Message msg;
+            sender->publish(topic, msg);
+            if (sender->get_statistics().outbox_refused != refused) return false;
+            accepted++;
+            return true;
+        };
+
+        auto flood_from = [&](int core, std::atomic<bool>& done, std::atomic<uint64_t>& sent,
+                              std::atomic<uint64_t>& refused) {
+            while (!done) {
+                if (publish(core)) {
+                    sent++;
+                } else {
+                    refused++;
+                    std::this_thread::yield();  // Backpressure: let the receiver catch up
+                }
+            }
+        };
+
+        auto run = [&](bool flood) {
+            std::atomic<bool> done{false};
+            std::atomic<uint64_t> flood_sent{0};
+            std::atomic<uint64_t> flood_refused{0};
+            {
+                std::lock_guard<std::mutex> lock(latencies_mutex);
+                latencies_us.clear();
+            }
+            sampling = true;
+
+            std::thread flooder;
+            if (flood) {
+                flooder = std::thread([&]() { flood_from(1, done, flood_sent, flood_refused); });
+            }
+
+            std::vector<std::thread> quiet;
+            for (int p = 2; p < NUM_CORES; ++p) {
+                quiet.emplace_back([&, p]() {
+                    for (int i = 0; i < 200; ++i) {
+                        publish(p);
+                        std::this_thread::sleep_for(std::chrono::microseconds(500));
+                    }
+                });
+            }
+            for (auto& t : quiet) t.join();
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            done = true;
+            if (flooder.joinable()) flooder.join();
+            sampling = false;
+
+            std::lock_guard<std::mutex> lock(latencies_mutex);
+            std::sort(latencies_us.begin(), latencies_us.end());
+            auto pct = [&](double q) {
+                if (latencies_us.empty()) return 0.0;
+                return latencies_us[static_cast<size_t>(q * (latencies_us.size() - 1))];
+            };
+            std::cout << (flood ? "With flood:    " : "Without flood: ")
+                      << "quiet p50=" << pct(0.5) << "us p99=" << pct(0.99) << "us"
+                      << " (" << latencies_us.size() << " handled)";
+            if (flood) {
+                std::cout << ", flooder " << flood_sent << " accepted / "
+                          << flood_refused << " pushed back";
+            }
+            std::cout << std::endl;
+        };
+
+        run(false);
+        run(true);
+
+        // Three sources with work queued at once should be served in turns.
+        // A timer holds core 0's worker while equal backlogs are queued, so
+        // the order it drains them in is the DRR's and not the OS scheduler's.
+        const int sources = 3;
+        const int queued_each = 120;
+        std::atomic<bool> holding{false}, release{false};
+        std::vector<int> order;
+
+        // Let the flood's backlog drain first
+        auto drain_by = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (handled < accepted && std::chrono::steady_clock::now() < drain_by) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        {
+            std::lock_guard<std::mutex> lock(latencies_mutex);
+            recording = &order;
+        }
+        receiver->set_timer(std::chrono::microseconds(0), [&]() {
+            holding = true;
+            while (!release) std::this_thread::yield();
+        });
+        while (!holding) std::this_thread::yield();
+
+        int queued = queued_each;
+        for (int c = 1; c <= sources; ++c) {
+            int pushed = 0;
+            while (pushed < queued_each && publish(c)) pushed++;
+            queued = std::min(queued, pushed);
+        }
+        release = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        receiver->unsubscribe(topic);
+
+        // While every source still has work queued, none may be served for
+        // more than one quantum in a row (plus one message of carried credit)
+        uint64_t share[NUM_CORES] = {};
+        uint64_t longest_turn = 0;
+        {
+            std::lock_guard<std::mutex> lock(latencies_mutex);
+            recording = nullptr;
+            size_t prefix = std::min(order.size(), static_cast<size_t>(queued * sources / 2));
+            uint64_t turn = 0;
+            for (size_t i = 0; i < prefix; ++i) {
+                share[order[i]]++;
+                turn = (i > 0 && order[i] == order[i - 1]) ? turn + 1 : 1;
+                longest_turn = std::max(longest_turn, turn);
+            }
+        }
+        Message probe;
+        probe.type = MSG_TOPIC_UPDATE;
+        uint64_t per_turn = DRR_QUANTUM_BYTES / wire_size(probe);
+        bool everyone_served = queued > 0;
+        std::cout << "Backlogged share (" << queued << " queued each):";
+        for (int c = 1; c <= sources; ++c) {
+            everyone_served = everyone_served && share[c] > 0;
+            std::cout << " core " << c << " " << share[c];
+        }
+        std::cout << ", longest turn " << longest_turn << " of " << per_turn << std::endl;
+        std::cout << "  -> Result: " << (everyone_served && longest_turn <= per_turn + 1 ? "PASS" : "FAIL")
+                  << " (backlogged sources take turns of at most one quantum)" << std::endl;
+    }
+
+    // 11. DEADLINES: Stale updates are dropped, fresh work is not
+    void test_message_expiry() {
+        std::cout << "\n--- MESSAGE DEADLINES (stale heartbeats under overload) ---" << std::endl;
+        CoreKernel* receiver = system.get_core(3);
+        CoreKernel* sender = system.get_core(4);
+        const int rounds = 200;
+        const int burst = 80;
+
+        // Each round publishes a burst of short-lived updates, one marker that
+        // is already past its deadline when sent and one request without a
+        // deadline. process_id tags them: -1 update, -2 marker, else the round.
+        std::mutex seen_mutex;
+        std::vector<char> fresh_seen(rounds, 0);
+        std::atomic<int> stale_handled{0};
+        std::atomic<int> updates_handled{0};
+        int topic = receiver->subscribe("expiry", [&](const Message& msg) {
+            if (msg.process_id == -2) {
+                stale_handled++;
+            } else if (msg.process_id == -1) {
+                updates_handled++;
+            } else {
+                std::lock_guard<std::mutex> lock(seen_mutex);
+                fresh_seen[msg.process_id] = 1;
+            }
+        });
+
+        // A refused publish shows up in the sender's outbox_refused
+        auto publish = [&](Message& msg) {
+            uint64_t refused = sender->get_statistics().outbox_refused;
+            sender->publish(topic, msg);
+            return sender->get_statistics().outbox_refused == refused;
+        };
+
+        CoreStatistics before = receiver->get_statistics();
+        for (int r = 0; r < rounds; ++r) {
+            for (int k = 0; k < burst; ++k) {
+                Message update;
+                update.process_id = -1;
+                update.set_ttl(std::chrono::microseconds(20));
+                publish(update);
+            }
+            Message stale;
+            stale.process_id = -2;
+            stale.set_ttl(std::chrono::microseconds(0));
+            publish(stale);
+
+            Message work;
+            work.process_id = r;
+            while (!publish(work)) std::this_thread::yield();
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+
+        // Every request was accepted, so wait for all of them to be handled
+        auto give_up = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        int fresh_handled = 0;
+        while (std::chrono::steady_clock::now() < give_up) {
+            {
+                std::lock_guard<std::mutex> lock(seen_mutex);
+                fresh_handled = static_cast<int>(std::count(fresh_seen.begin(), fresh_seen.end(), 1));
+            }
+            if (fresh_handled == rounds) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        receiver->unsubscribe(topic);
+        CoreStatistics after = receiver->get_statistics();
+
+        uint64_t expired = after.messages_expired - before.messages_expired;
+        std::cout << "Sent " << rounds * (burst + 2) << " (" << rounds << " without deadline, "
+                  << rounds << " already stale): " << expired << " expired and dropped" << std::endl;
+        std::cout << "  Handlers saw " << fresh_handled << "/" << rounds << " requests, "
+                  << updates_handled.load() << " live updates, " << stale_handled.load()
+                  << " stale markers" << std::endl;
+        std::cout << "  -> Result: "
+                  << (stale_handled == 0 && fresh_handled == rounds ? "PASS" : "FAIL")
+                  << " (no expired message reached a handler, every request did)" << std::endl;
+    }
+
+    // 12. BUDGET: Processes keep running through a message storm
+    void test_message_storm() {
+        std::cout << "\n--- MESSAGE STORM (per-pass handling budget) ---" << std::endl;
+        const int target = 6;
+        CoreKernel* receiver = system.get_core(target);
+        for (int i = 0; i < 20; ++i) {
+            receiver->create_process(5);
+        }
+
+        CoreStatistics before = receiver->get_statistics();
+        std::atomic<bool> done{false};
+        std::vector<std::thread> flooders;
+        for (int p = 1; p <= 3; ++p) {
+            flooders.emplace_back([&, p]() {
+                while (!done) {
+                    Message msg;
+                    msg.source_core = p;
+                    msg.dest_core = target;
+                    if (!system.get_core(p)->send_message(msg)) std::this_thread::yield();
+                }
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        done = true;
+        for (auto& t : flooders) t.join();
+        CoreStatistics after = receiver->get_statistics();
+
+        uint64_t msg_us = after.message_time_us - before.message_time_us;
+        uint64_t proc_us = after.process_time_us - before.process_time_us;
+        std::cout << "Handled " << (after.messages_received - before.messages_received)
+                  << " messages and " << (after.processes_executed - before.processes_executed)
+                  << " process slices in 500 ms" << std::endl;
+        std::cout << "  Split: " << msg_us << " us messages / " << proc_us << " us processes"
+                  << ", budget now " << after.message_budget << " (cut short "
+                  << (after.budget_exhaustions - before.budget_exhaustions) << " times)" << std::endl;
+    }
+
+    // 13. URGENT DELIVERY: Latency of urgent messages under process load
+    void test_urgent_delivery() {
+        std::cout << "\n--- URGENT DELIVERY (heavy process load) ---" << std::endl;
+        const int target = 2;
+        CoreKernel* receiver = system.get_core(target);
+        CoreKernel* sender = system.get_core(3);
+
+        // Keep the target's run queue deep for the whole run, and make each
+        // slice cost real time so a pass is long enough to be interrupted
+        receiver->set_process_slice(200);
+        std::atomic<bool> done{false};
+        std::thread loader([&]() {
+            while (!done) {
+                while (receiver->get_load() < 40) receiver->create_process(3);
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+        });
+
+        CoreStatistics before = receiver->get_statistics();
+        for (int i = 0; i < 200; ++i) {
+            Message msg;
+            msg.source_core = 3;
+            msg.dest_core = target;
+            msg.urgent = true;
+            sender->send_message(msg);
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        done = true;
+        loader.join();
+        receiver->set_process_slice(0);
+        CoreStatistics after = receiver->get_statistics();
+
+        uint64_t handled = after.urgent_messages - before.urgent_messages;
+        uint64_t latency = after.urgent_latency_us - before.urgent_latency_us;
+        uint64_t preempted = after.preemptions - before.preemptions;
+        std::cout << handled << " urgent messages, avg latency "
+                  << (handled ? latency / handled : 0) << " us, "
+                  << preempted << " scheduler passes preempted" << std::endl;
+        std::cout << "  -> Result: " << (preempted > 0 && handled == 200 ? "PASS" : "FAIL")
+                  << " (urgent messages must interrupt scheduler passes)" << std::endl;
+    }
+
+    // 14. OUTBOX: Staged, per-destination batches vs one send per message
+    void test_outbox_batching() {
+        std::cout << "\n--- OUTBOX BATCHING (one sender, bursts of 50) ---" << std::endl;
+        const int total = 20000;
+        const int burst = 50;
+        CoreKernel* sender = system.get_core(1);
+        CoreKernel* receiver = system.get_core(0);
+
+        auto run = [&](bool staged) {
+            CoreStatistics before = sender->get_statistics();
+            auto start = std::chrono::high_resolution_clock::now();
+
+            for (int sent = 0; sent < total; sent += burst) {
+                uint64_t target = receiver->get_statistics().messages_received + burst;
+                for (int k = 0; k < burst; ++k) {
+                    Message msg;
+                    msg.source_core = 1;
+                    msg.dest_core = 0;
+                    if (staged) sender->stage_message(msg);
+                    else sender->send_message(msg);
+                }
+                if (staged) sender->flush_outbox();
+                while (receiver->get_statistics().messages_received < target) {
+                    std::this_thread::yield();
+                }
+            }
+
+            std::chrono::duration<double> elapsed =
+                std::chrono::high_resolution_clock::now() - start;
+            CoreStatistics after = sender->get_statistics();
+            std::cout << (staged ? "Outbox:       " : "send_message: ")
+                      << (total / elapsed.count()) << " msgs/s, "
+                      << (after.wakeups_sent - before.wakeups_sent) << " wakeups" << std::endl;
+        };
+
+        run(false);
+        run(true);
+    }
+
+    // 15. COALESCING: Throughput of bursts and the delay paid by a lone send
+    void test_send_coalescing() {
+        std::cout << "\n--- SEND COALESCING (MSG_HEARTBEAT, 200 us budget) ---" << std::endl;
+        const int total = 20000;
+        const int burst = 64;
+        CoreKernel* sender = system.get_core(1);
+        CoreKernel* receiver = system.get_core(0);
+
+        auto send_one = [&]() {
+            Message msg;
+            msg.source_core = 1;
+            msg.dest_core = 0;
+            sender->send_message(msg);
+        };
+        auto wait_for_count = [&](uint64_t target) {
+            while (receiver->get_statistics().messages_received < target) {
+                std::this_thread::yield();
+            }
+        };
+
+        auto run = [&](const char* label) {
+            CoreStatistics before = sender->get_statistics();
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int sent = 0; sent < total; sent += burst) {
+                uint64_t target = receiver->get_statistics().messages_received + burst;
+                for (int k = 0; k < burst; ++k) send_one();
+                wait_for_count(target);
+            }
+            std::chrono::duration<double> elapsed =
+                std::chrono::high_resolution_clock::now() - start;
+
+            // A lone send waits out the whole budget before it is published
+            double lone_us = 0;
+            for (int i = 0; i < 50; ++i) {
+                uint64_t target = receiver->get_statistics().messages_received + 1;
+                auto t0 = std::chrono::high_resolution_clock::now();
+                send_one();
+                wait_for_count(target);
+                lone_us += std::chrono::duration<double, std::micro>(
+                    std::chrono::high_resolution_clock::now() - t0).count();
+            }
+
+            CoreStatistics after = sender->get_statistics();
+            std::cout << label << (total / elapsed.count()) << " msgs/s, "
+                      << (after.wakeups_sent - before.wakeups_sent) << " wakeups, lone send "
+                      << (lone_us / 50) << " us" << std::endl;
+        };
+
+        // Establish the channel first; bursts would overrun the bootstrap quota
+        send_one();
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        run("Off: ");
+        system.set_coalescing(MSG_HEARTBEAT, 200, 32);
+        run("On:  ");
+        system.set_coalescing(MSG_HEARTBEAT, 0);
+    }
+
+    // 16. PIGGYBACKING: Peer state from regular traffic, heartbeats only when idle
+    void test_piggyback_metadata() {
+        std::cout << "\n--- PIGGYBACKED PEER STATE (1 busy link, 1 idle link) ---" << std::endl;
+        CoreKernel* receiver = system.get_core(0);
+
+        auto totals = [&]() {
+            uint64_t sent = 0, piggybacked = 0;
+            for (int i = 0; i < NUM_CORES; ++i) {
+                CoreStatistics st = system.get_core(i)->get_statistics();
+                sent += st.heartbeats_sent;
+                piggybacked += st.peer_updates_piggybacked;
+            }
+            return std::make_pair(sent, piggybacked);
+        };
+
+        auto before = totals();
+
+        // Core 2 opens its link and goes quiet; core 1 keeps talking
+        Message hello;
+        hello.source_core = 2;
+        hello.dest_core = 0;
+        system.get_core(2)->send_message(hello);
+
+        auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(1500);
+        while (std::chrono::steady_clock::now() < end) {
+            Message msg;
+            msg.source_core = 1;
+            msg.dest_core = 0;
+            system.get_core(1)->send_message(msg);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        auto after = totals();
+        for (int peer = 1; peer <= 2; ++peer) {
+            int load;
+            uint32_t epoch;
+            int64_t age_ms;
+            if (receiver->get_peer_state(peer, load, epoch, age_ms)) {
+                std::cout << "Core 0 view of Core " << peer << ": load " << load
+                          << " (actual " << system.get_core(peer)->get_load() << "), epoch "
+                          << epoch << ", " << age_ms << " ms old" << std::endl;
+            }
+        }
+        std::cout << "Heartbeats: " << (after.first - before.first) << " sent, "
+                  << (after.second - before.second) << " peer updates piggybacked on regular traffic"
+                  << std::endl;
+    }
+
+    void test_waitset() {
+        std::cout << "\n--- WAIT SET (2 mailboxes, 2 ms timer, 1 eventfd) ---" << std::endl;
+        CoreKernel* owner = system.get_core(5);
+
+        // This thread runs both processes; the first receive_mail claims them.
+        // The demo scheduler may end one before that, so make another.
+        WaitSet waitset;
+        int pids[2], mail_ids[2];
+        Message msg;
+        for (int i = 0; i < 2; ++i) {
+            do {
+                pids[i] = owner->create_process(5);
+                owner->receive_mail(pids[i], msg, 0);
+                mail_ids[i] = waitset.add_mailbox(owner, pids[i]);
+            } while (mail_ids[i] < 0);
+        }
+        int timer_id = waitset.add_timer(std::chrono::microseconds(2000));
+        int efd = eventfd(0, EFD_NONBLOCK);
+        int fd_id = waitset.add_fd(efd);
+
+        std::atomic<bool> running{true};
+        std::atomic<uint64_t> mail_sent{0};
+        std::thread producer([&]() {
+            int round = 0;
+            while (running) {
+                Message mail;
+                if (system.get_core(4)->send_mail(pids[round % 2], mail)) mail_sent++;
+                if (++round % 2 == 0) {
+                    uint64_t one = 1;
+                    if (write(efd, &one, sizeof(one)) < 0) break;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+        });
+
+        uint64_t mail_events = 0, mail_received = 0, timer_ticks = 0, fd_events = 0, waits = 0;
+        std::vector<WaitEvent> ready;
+        auto stop_at = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+        auto give_up = stop_at + std::chrono::milliseconds(200);
+        while (std::chrono::steady_clock::now() < give_up) {
+            if (running && std::chrono::steady_clock::now() >= stop_at) {
+                running = false;
+                producer.join();
+            }
+            if (!running && mail_received == mail_sent) break;
+
+            waitset.wait(ready, 50);
+            waits++;
+            for (const auto& ev : ready) {
+                for (int i = 0; i < 2; ++i) {
+                    if (ev.id != mail_ids[i]) continue;
+                    // Readiness is level-triggered: drain, or the next wait returns at once
+                    while (owner->receive_mail(pids[i], msg, 0)) mail_received++;
+                    mail_events++;
+                }
+                if (ev.id == timer_id) timer_ticks += ev.count;
+                if (ev.id == fd_id) {
+                    uint64_t count;
+                    if (read(efd, &count, sizeof(count)) > 0) fd_events += count;
+                }
+            }
+        }
+        if (running) {
+            running = false;
+            producer.join();
+        }
+
+        for (int i = 0; i < 2; ++i) {
+            waitset.remove(mail_ids[i]);
+            owner->terminate_process(pids[i]);
+        }
+        close(efd);
+
+        std::cout << "Waits: " << waits << ", mailbox readiness: " << mail_events
+                  << " (" << mail_received << "/" << mail_sent << " mail)"
+                  << ", timer ticks: " << timer_ticks << ", eventfd signals: " << fd_events << std::endl;
+        std::cout << "  -> Result: "
+                  << (mail_received == mail_sent && timer_ticks > 0 && fd_events > 0 ? "PASS" : "FAIL")
+                  << " (all mail, timer ticks and eventfd signals seen by one waiter)" << std::endl;
+
+        // A core's inbox belongs to its worker: this thread may not watch it,
+        // a timer callback on the worker may, and it sees a message land
+        WaitSet outsider;
+        bool refused = outsider.add_inbox(owner) < 0;
+        std::atomic<int> inbox_state{0};    // 1: watching, 2: reported, 3: not
+        owner->set_timer(std::chrono::microseconds(0), [&]() {
+            WaitSet own;
+            bool reported = false;
+            if (own.add_inbox(owner) >= 0) {
+                inbox_state = 1;
+                std::vector<WaitEvent> seen;
+                auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+                while (!reported && own.wait_until(seen, until) > 0) {
+                    for (const auto& ev : seen) reported = reported || ev.kind == WAIT_INBOX;
+                }
+            }
+            inbox_state = reported ? 2 : 3;    // Last touch: the test may return now
+        });
+        while (inbox_state == 0) std::this_thread::yield();
+        Message ping;
+        ping.source_core = 4;
+        ping.dest_core = 5;
+        system.get_core(4)->send_message(ping);
+        while (inbox_state == 1) std::this_thread::yield();
+        std::cout << "Core inbox: " << (refused ? "refused" : "accepted") << " off the worker, "
+                  << (inbox_state == 2 ? "reported" : "missed") << " a message on it" << std::endl;
+        std::cout << "  -> Result: " << (refused && inbox_state == 2 ? "PASS" : "FAIL")
+                  << " (only the owning worker waits on its inbox)" << std::endl;
+    }
+
+    void test_topic_fanout() {
+        std::cout << "\n--- TOPICS (3 subscribers vs broadcast to 7 cores) ---" << std::endl;
+        const int updates = 200;
+        std::atomic<int> received[NUM_CORES] = {};
+
+        int topic = -1;
+        for (int core : {1, 3, 6}) {
+            topic = system.get_core(core)->subscribe("load", [&received, core](const Message&) {
+                received[core]++;
+            });
+        }
+
+        CoreKernel* publisher = system.get_core(0);
+        auto start = std::chrono::steady_clock::now();
+        int copies = 0;
+        for (int i = 0; i < updates; ++i) {
+            Message msg;
+            snprintf(msg.data, MAX_MESSAGE_SIZE, "load=%d", i);
+            copies += publisher->publish(topic, msg);
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        for (int core : {1, 3, 6}) system.get_core(core)->unsubscribe(topic);
+
+        int subscribed = 0, leaked = 0;
+        for (int i = 0; i < NUM_CORES; ++i) {
+            if (i == 1 || i == 3 || i == 6) subscribed += received[i];
+            else leaked += received[i];
+        }
+        std::cout << "Publishes: " << updates << ", copies sent: " << copies
+                  << " (broadcast would send " << updates * (NUM_CORES - 1) << ")" << std::endl;
+        std::cout << "Delivered to subscribers: " << subscribed << "/" << copies
+                  << ", to others: " << leaked << ", publish loop: " << elapsed << " us" << std::endl;
+    }
+
+    void test_variable_payloads() {
+        std::cout << "\n--- VARIABLE-LENGTH MESSAGES (bytes moved per message) ---" << std::endl;
+        struct Mix { const char* name; int small_pct; int medium_pct; };  // Rest are full size
+        const Mix mixes[] = {
+            {"control (16-64 B)", 100, 0},
+            {"mixed (70/25/5)", 70, 25},
+            {"bulk (512 B)", 0, 0},
+        };
+        const int total = 200000;
+        const int burst = 32;
+
+        for (const auto& mix : mixes) {
+            auto arena = std::make_shared<HugePageArena>();
+            Channel channel(0, 1, arena);
+            std::vector<Message> fixed_ring(CHANNEL_CAPACITY);
+            PeerMeta meta;
+            unsigned seed = 42;
+
+            // Pre-generate the payload sizes so both paths copy the same traffic
+            std::vector<size_t> sizes(total);
+            for (auto& size : sizes) {
+                int roll = rand_r(&seed) % 100;
+                if (roll < mix.small_pct) size = 16 + rand_r(&seed) % 49;
+                else if (roll < mix.small_pct + mix.medium_pct) size = 128 + rand_r(&seed) % 129;
+                else size = MAX_MESSAGE_SIZE;
+            }
+
+            Message out, in;
+            char fill[MAX_MESSAGE_SIZE];
+            uint64_t payload_bytes = 0, mismatches = 0;
+            uint64_t before = channel.get_bytes_written();
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < total; i += burst) {
+                int n = std::min(burst, total - i);
+                for (int k = 0; k < n; ++k) {
+                    size_t len = sizes[i + k];
+                    memset(fill, static_cast<char>(i + k), len);
+                    out.set_payload(fill, len);
+                    out.process_id = i + k;
+                    if (!channel.push(out, meta)) mismatches++;
+                    payload_bytes += len;
+                }
+                for (int k = 0; k < n; ++k) {
+                    if (!channel.pop(in) || in.process_id != i + k || in.data_len != sizes[i + k] ||
+                        in.data[in.data_len - 1] != static_cast<char>(i + k)) {
+                        mismatches++;
+                    }
+                }
+            }
+            auto variable_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::high_resolution_clock::now() - start).count();
+            uint64_t moved = channel.get_bytes_written() - before;
+
+            // The old layout: every message copied whole, into and out of the
+            // ring, under the same lock and idle stamp the channel takes
+            std::mutex ring_mutex;
+            std::atomic<int64_t> last_used{0};
+            start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < total; i += burst) {
+                int n = std::min(burst, total - i);
+                for (int k = 0; k < n; ++k) {
+                    memset(fill, static_cast<char>(i + k), sizes[i + k]);
+                    out.set_payload(fill, sizes[i + k]);
+                    out.process_id = i + k;
+                    std::lock_guard<std::mutex> lock(ring_mutex);
+                    fixed_ring[k] = out;
+                    last_used.store(steady_now_ms(), std::memory_order_relaxed);
+                }
+                for (int k = 0; k < n; ++k) {
+                    std::lock_guard<std::mutex> lock(ring_mutex);
+                    in = fixed_ring[k];
+                    if (in.process_id != i + k || in.data[in.data_len - 1] != static_cast<char>(i + k)) {
+                        mismatches++;
+                    }
+                }
+            }
+            auto fixed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::high_resolution_clock::now() - start).count();
+
+            std::cout << mix.name << ": avg payload " << payload_bytes / total << " B, moved "
+                      << moved / total << " B/msg vs " << sizeof(Message) << " fixed ("
+                      << (100 * moved) / (static_cast<uint64_t>(total) * sizeof(Message)) << "%), "
+                      << variable_ns / total << " ns/msg vs " << fixed_ns / total << " ns fixed, "
+                      << mismatches << " mismatches" << std::endl;
+        }
+    }
+
+    void test_adaptive_capacity() {
+        std::cout << "\n--- ADAPTIVE CHANNEL CAPACITY (flood, idle, then flood on a tight budget) ---" << std::endl;
+        CoreKernel* sender = system.get_core(2);
+        CoreKernel* receiver = system.get_core(3);
+
+        Message warm;
+        warm.source_core = 2;
+        warm.dest_core = 3;
+        sender->send_message(warm);
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        auto flood = [&](int ms) {
+            uint64_t accepted = 0, refused = 0;
+            auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+            while (std::chrono::steady_clock::now() < end) {
+                Message msg;
+                msg.source_core = 2;
+                msg.dest_core = 3;
+                msg.set_payload(std::string("update"));
+                if (sender->send_message(msg)) {
+                    accepted++;
+                } else {
+                    refused++;
+                    std::this_thread::yield();
+                }
+            }
+            return std::make_pair(accepted, refused);
+        };
+        auto report = [&](const char* phase, std::pair<uint64_t, uint64_t> sent) {
+            CoreStatistics st = receiver->get_statistics();
+            std::cout << phase << ": " << sent.first << " accepted, " << sent.second << " refused, ring "
+                      << st.channel_bytes / 1024 << " KiB (" << st.channel_grows << " grows, "
+                      << st.channel_shrinks << " shrinks, " << st.channel_grows_denied << " denied)" << std::endl;
+        };
+
+        report("First 100 ms of flood", flood(100));
+        report("Next 500 ms of flood ", flood(500));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+        report("After 1.5 s idle     ", std::make_pair(0ULL, 0ULL));
+
+        uint64_t saved = channel_memory_budget();
+        set_channel_memory_budget(channel_memory_in_use());
+        report("Flood at full budget ", flood(500));
+        set_channel_memory_budget(saved);
+    }
+
+    void test_timer_wheel() {
+        std::cout << "\n--- TIMER WHEEL (1M timers: set, cancel half, expire the rest) ---" << std::endl;
+        const int N = 1000000;
+        using clock = std::chrono::steady_clock;
+        auto start = clock::now();
+
+        // Timeouts spread from 100 us to ~10 s, as a busy core would set them
+        std::vector<clock::time_point> when(N);
+        uint64_t x = 88172645463325252ULL;
+        for (int i = 0; i < N; i++) {
+            x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+            when[i] = start + std::chrono::microseconds(100 + x % 10000000);
+        }
+        uint64_t fired = 0;
+        auto tick = [&fired]() { fired++; };
+
+        // Simulated time moves forward 1 ms per 100 sets, so expiry is
+        // interleaved with the churn rather than all at the end
+        auto churn = [&](auto set, auto cancel, auto expire) {
+            fired = 0;
+            auto t0 = clock::now();
+            clock::time_point now = start;
+            for (int i = 0; i < N; i++) {
+                set(i);
+                if (i % 2 == 1) cancel(i - 1);
+                if (i % 100 == 99) {
+                    now += std::chrono::milliseconds(1);
+                    expire(now);
+                }
+            }
+            expire(start + std::chrono::seconds(20));
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - t0).count();
+        };
+
+        TimerWheel wheel(std::chrono::microseconds(TIMER_WHEEL_TICK_US), start);
+        std::vector<uint64_t> wheel_ids(N);
+        std::vector<TimerWheel::Callback> due;
+        int64_t wheel_ns = churn(
+            [&](int i) { wheel_ids[i] = wheel.schedule(when[i], tick); },
+            [&](int i) { wheel.cancel(wheel_ids[i]); },
+            [&](clock::time_point now) {
+                due.clear();
+                wheel.advance(now, due);
+                for (auto& cb : due) cb();
+            });
+        uint64_t wheel_fired = fired;
+
+        // Baseline: an ordered map, as a deadline queue with cancel usually is
+        std::multimap<clock::time_point, std::function<void()>> queue;
+        std::vector<std::multimap<clock::time_point, std::function<void()>>::iterator> map_ids(N);
+        std::vector<bool> map_live(N, false);
+        int64_t map_ns = churn(
+            [&](int i) { map_ids[i] = queue.emplace(when[i], tick); map_live[i] = true; },
+            [&](int i) { if (map_live[i]) { queue.erase(map_ids[i]); map_live[i] = false; } },
+            [&](clock::time_point now) {
+                while (!queue.empty() && queue.begin()->first <= now) {
+                    auto cb = std::move(queue.begin()->second);
+                    queue.erase(queue.begin());
+                    cb();
+                }
+            });
+        uint64_t map_fired = fired;
+
+        int ops = N + N / 2;    // Sets plus cancels; expiry is paid for inside them
+        std::cout << "Timer wheel: " << wheel_ns / ops << " ns/op, " << wheel_fired << " fired" << std::endl;
+        std::cout << "Ordered map: " << map_ns / ops << " ns/op, " << map_fired << " fired" << std::endl;
+
+        // On a worker: how late do callbacks run past the time asked for?
+        CoreKernel* core = system.get_core(1);
+        CoreStatistics before = core->get_statistics();
+        std::atomic<int> done{0};
+        for (int i = 0; i < 200; i++) {
+            core->set_timer(std::chrono::microseconds(500 + i * 100), [&done]() { done++; });
+        }
+        uint64_t doomed = core->set_timer(std::chrono::seconds(1), [&done]() { done += 1000; });
+        bool cancelled = core->cancel_timer(doomed);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        CoreStatistics after = core->get_statistics();
+        uint64_t fired_here = after.timers_fired - before.timers_fired;
+        int64_t late = after.timer_lateness_us - before.timer_lateness_us;
+        std::cout << "Worker timers: " << done.load() << "/200 ran, cancel "
+                  << (cancelled ? "ok" : "FAILED") << ", avg "
+                  << (fired_here ? late / static_cast<int64_t>(fired_here) : 0)
+                  << " us past due (tick " << TIMER_WHEEL_TICK_US << " us)" << std::endl;
+    }
+
+    void test_process_mail() {
+        std::cout << "\n--- PROCESS MAIL (ping-pong, same core vs cross core) ---" << std::endl;
+        const int rounds = 2000;
+
+        // Two threads stand in for the processes, each blocking in its own
+        // mailbox; returns one-way latencies in microseconds
+        auto ping_pong = [&](int core_a, int core_b) {
+            CoreKernel* a = system.get_core(core_a);
+            CoreKernel* b = system.get_core(core_b);
+            int pid_a = a->create_process();
+            int pid_b = b->create_process();
+            std::vector<double> one_way;
+
+            std::thread echo([&]() {
+                Message msg;
+                for (int i = 0; i < rounds; i++) {
+                    if (!b->receive_mail(pid_b, msg, 1000)) break;
+                    b->send_mail(pid_a, msg);
+                }
+            });
+
+            Message msg;
+            for (int i = 0; i < rounds; i++) {
+                snprintf(msg.data, MAX_MESSAGE_SIZE, "ping=%d", i);
+                auto sent = std::chrono::steady_clock::now();
+                if (!a->send_mail(pid_b, msg) || !a->receive_mail(pid_a, msg, 1000)) break;
+                one_way.push_back(std::chrono::duration<double, std::micro>(
+                    std::chrono::steady_clock::now() - sent).count() / 2);
+            }
+            echo.join();
+            a->terminate_process(pid_a);
+            b->terminate_process(pid_b);
+
+            std::sort(one_way.begin(), one_way.end());
+            return one_way;
+        };
+
+        auto report = [](const char* label, const std::vector<double>& lat) {
+            if (lat.empty()) {
+                std::cout << label << ": no round trips completed" << std::endl;
+                return;
+            }
+            std::cout << label << ": " << lat.size() << " round trips, one-way p50 "
+                      << lat[lat.size() / 2] << " us, p99 " << lat[lat.size() * 99 / 100]
+                      << " us" << std::endl;
+        };
+
+        CoreStatistics before = system.get_core(1)->get_statistics();
+        report("Same core (1 -> 1) ", ping_pong(1, 1));
+        CoreStatistics after = system.get_core(1)->get_statistics();
+        report("Cross core (1 -> 2)", ping_pong(1, 2));
+        report("Cross node (1 -> 5)", ping_pong(1, 5));
+
+        std::cout << "Same-core mail that skipped the channels: "
+                  << after.mail_local - before.mail_local << "/"
+                  << after.mail_sent - before.mail_sent << std::endl;
+    }
+
+    void test_name_service() {
+        std::cout << "\n--- NAME SERVICE (cached resolve vs shared registry, then invalidation) ---" << std::endl;
+        const int lookups = 200000;
+        const int readers[] = {4, 5, 6, 7};
+
+        system.get_core(2)->register_service("echo", 7);
+
+        // Four cores resolving the same name: from their caches, then all
+        // going to one registry behind one lock
+        auto timed = [&](auto resolve_on) {
+            auto start = std::chrono::steady_clock::now();
+            std::vector<std::thread> threads;
+            for (int core : readers) {
+                threads.emplace_back([&, core]() {
+                    ServiceAddress address;
+                    for (int i = 0; i < lookups; i++) resolve_on(core, address);
+                });
+            }
+            for (auto& t : threads) t.join();
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count() / (lookups * 4);
+        };
+
+        NameService shared;
+        ServiceAddress echo;
+        echo.core = 2;
+        echo.port = 7;
+        shared.bind("echo", echo, -1);
+
+        // Cached lookups run where a service would make them, on each reader's worker
+        std::atomic<int> finished{0};
+        auto cached_start = std::chrono::steady_clock::now();
+        for (int core : readers) {
+            CoreKernel* reader = system.get_core(core);
+            reader->set_timer(std::chrono::microseconds(0), [&, reader]() {
+                ServiceAddress address;
+                for (int i = 0; i < lookups; i++) reader->resolve("echo", address);
+                finished++;
+            });
+        }
+        while (finished.load() < 4) std::this_thread::sleep_for(std::chrono::microseconds(100));
+        int64_t cached_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - cached_start).count() / (lookups * 4);
+        int64_t shared_ns = timed([&](int, ServiceAddress& address) {
+            uint64_t generation;
+            shared.lookup("echo", address, generation);
+        });
+        CoreStatistics st = system.get_core(5)->get_statistics();
+        std::cout << "Per-core cache:  " << cached_ns << " ns/resolve (" << st.name_cache_hits
+                  << " hits, " << st.name_cache_misses << " misses on core 5)" << std::endl;
+        std::cout << "Shared registry: " << shared_ns << " ns/resolve" << std::endl;
+        std::cout << "  -> Result: " << (cached_ns < shared_ns ? "PASS" : "FAIL")
+                  << " (cached resolve must beat the shared registry)" << std::endl;
+
+        // How long until a reader's cache follows a change
+        auto converge = [&](const char* what, const std::string& name, int expect_core) {
+            auto start = std::chrono::steady_clock::now();
+            ServiceAddress address;
+            bool found = false;
+            while (std::chrono::steady_clock::now() - start < std::chrono::seconds(1)) {
+                found = system.get_core(5)->resolve(name, address);
+                if (found ? address.core == expect_core : expect_core < 0) break;
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+            auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count();
+            std::cout << what << ": core 5 resolves " << name << " to "
+                      << (found ? "core " + std::to_string(address.core) : std::string("nothing"))
+                      << " after " << us << " us" << std::endl;
+        };
+
+        system.get_core(3)->register_service("echo", 9);
+        converge("Re-registered on core 3", "echo", 3);
+
+        // A name owned by a process moves with it and goes when it exits
+        CoreKernel* home = system.get_core(1);
+        int pid = home->create_process();
+        Message none;
+        home->receive_mail(pid, none, 0);   // This thread drives it; the demo scheduler leaves it be
+        home->register_service("kv", 11, pid);
+        converge("Owner on core 1        ", "kv", 1);
+        home->migrate_process(pid, 6);
+        converge("Owner migrated to core 6", "kv", 6);
+        system.get_core(6)->terminate_process(pid);
+        converge("Owner terminated       ", "kv", -1);
+
+        system.get_core(3)->unregister_service("echo");
+    }
 };
 
 // Integration into your main
@@ -62,4 +1379,24 @@ void run_all_tests(MultikernelSystem& system) {
     tester.test_message_consistency();
     tester.test_race_conditions();
     tester.run_performance_profile();
+    tester.test_creation_scaling();
+    tester.test_combining_throughput();
+    tester.test_submission_rings();
+    tester.test_hugepage_tlb();
+    tester.test_layout_contention();
+    tester.test_wakeup_suppression();
+    tester.test_fair_draining();
+    tester.test_message_expiry();
+    tester.test_message_storm();
+    tester.test_urgent_delivery();
+    tester.test_outbox_batching();
+    tester.test_send_coalescing();
+    tester.test_piggyback_metadata();
+    tester.test_waitset();
+    tester.test_topic_fanout();
+    tester.test_variable_payloads();
+    tester.test_adaptive_capacity();
+    tester.test_timer_wheel();
+    tester.test_process_mail();
+    tester.test_name_service();
 }
@@ -0,0 +1,188 @@
+#include "multikernel.h"
+#include <algorithm>
+
+// ============================================================================
+// TIMER WHEEL IMPLEMENTATION
+// ============================================================================
+
+TimerWheel::TimerWheel(std::chrono::microseconds tick_length,
+                       std::chrono::steady_clock::time_point start)
+    : origin(start), tick(tick_length) {
+    for (auto& level : heads) {
+        std::fill(std::begin(level), std::end(level), NIL);
+    }
+}
+
+void TimerWheel::link(uint32_t index) {
+    Node& node = nodes[index];
+    if (node.expires < current) node.expires = current;
+    
+    // Beyond the top level's reach, file it at the horizon; each cascade
+    // re-files it against its real expiry until it comes within range
+    uint64_t horizon = current + (1ULL << (SLOT_BITS * LEVELS)) - 1;
+    uint64_t file_at = std::min(node.expires, horizon);
+    
+    // Pick the lowest level whose span still reaches the expiry
+    uint64_t delta = file_at - current;
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (1ULL << (SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+    int slot = static_cast<int>((file_at >> (SLOT_BITS * level)) & (SLOTS - 1));
+    
+    node.level = static_cast<uint16_t>(level);
+    node.slot = static_cast<uint16_t>(slot);
+    node.prev = NIL;
+    node.next = heads[level][slot];
+    if (node.next != NIL) nodes[node.next].prev = index;
+    heads[level][slot] = index;
+    occupied[level][slot / 64] |= 1ULL << (slot % 64);
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    Node& node = nodes[index];
+    if (node.prev != NIL) {
+        nodes[node.prev].next = node.next;
+    } else {
+        heads[node.level][node.slot] = node.next;
+    }
+    if (node.next != NIL) nodes[node.next].prev = node.prev;
+    
+    if (heads[node.level][node.slot] == NIL) {
+        occupied[node.level][node.slot / 64] &= ~(1ULL << (node.slot % 64));
+    }
+}
+
+void TimerWheel::release(uint32_t index) {
+    Node& node = nodes[index];
+    node.armed = false;
+    node.generation++;
+    node.callback = nullptr;
+    free_nodes.push_back(index);
+    armed_count--;
+}
+
+uint64_t TimerWheel::schedule(std::chrono::steady_clock::time_point when, Callback callback) {
+    uint32_t index;
+    if (!free_nodes.empty()) {
+        index = free_nodes.back();
+        free_nodes.pop_back();
+    } else {
+        index = static_cast<uint32_t>(nodes.size());
+        nodes.emplace_back();
+    }
+    
+    // Round up: a timer never fires before its time
+    auto offset = std::max(when - origin, std::chrono::steady_clock::duration::zero());
+    uint64_t ticks = static_cast<uint64_t>((offset + tick - std::chrono::nanoseconds(1)) / tick);
+    
+    Node& node = nodes[index];
+    node.expires = ticks;
+    node.callback = std::move(callback);
+    node.armed = true;
+    armed_count++;
+    link(index);
+    
+    return (static_cast<uint64_t>(node.generation) << 32) | index;
+}
+
+bool TimerWheel::cancel(uint64_t id) {
+    uint32_t index = static_cast<uint32_t>(id);
+    uint32_t generation = static_cast<uint32_t>(id >> 32);
+    if (index >= nodes.size()) return false;
+    
+    Node& node = nodes[index];
+    if (!node.armed || node.generation != generation) return false;
+    
+    unlink(index);
+    release(index);
+    return true;
+}
+
+bool TimerWheel::cascade(int level) {
+    int slot = static_cast<int>((current >> (SLOT_BITS * level)) & (SLOTS - 1));
+    
+    uint32_t index = heads[level][slot];
+    heads[level][slot] = NIL;
+    occupied[level][slot / 64] &= ~(1ULL << (slot % 64));
+    
+    while (index != NIL) {
+        uint32_t next = nodes[index].next;
+        link(index);
+        index = next;
+    }
+    return slot == 0;
+}
+
+size_t TimerWheel::advance(std::chrono::steady_clock::time_point now, std::vector<Callback>& due) {
+    if (now < origin) return 0;
+    uint64_t target = static_cast<uint64_t>((now - origin) / tick);
+    size_t fired = 0;
+    
+    while (current <= target) {
+        int slot = static_cast<int>(current & (SLOTS - 1));
+        
+        // Entering a new level-0 lap: pull the next span down from above
+        if (slot == 0) {
+            for (int level = 1; level < LEVELS && cascade(level); level++) {}
+        }
+        
+        uint32_t index = heads[0][slot];
+        heads[0][slot] = NIL;
+        occupied[0][slot / 64] &= ~(1ULL << (slot % 64));
+        while (index != NIL) {
+            uint32_t next = nodes[index].next;
+            due.push_back(std::move(nodes[index].callback));
+            release(index);
+            fired++;
+            index = next;
+        }
+        
+        // Skip straight over empty ticks up to the end of this lap
+        int ahead = next_level0_slot();
+        uint64_t lap_end = (current | (SLOTS - 1)) + 1;
+        uint64_t next = (ahead > slot) ? (current - slot + ahead) : lap_end;
+        current = std::min(std::max(next, current + 1), target + 1);
+    }
+    return fired;
+}
+
+int TimerWheel::next_level0_slot() const {
+    int start = static_cast<int>(current & (SLOTS - 1));
+    for (int step = 0; step < SLOTS; ) {
+        int slot = (start + step) & (SLOTS - 1);
+        uint64_t word = occupied[0][slot / 64] >> (slot % 64);
+        if (word) return slot + __builtin_ctzll(word);
+        step += 64 - slot % 64;
+    }
+    return -1;
+}
+
+bool TimerWheel::higher_levels_occupied() const {
+    for (int level = 1; level < LEVELS; level++) {
+        for (uint64_t word : occupied[level]) {
+            if (word) return true;
+        }
+    }
+    return false;
+}
+
+std::chrono::steady_clock::time_point TimerWheel::next_deadline() const {
+    if (armed_count == 0) return std::chrono::steady_clock::time_point::max();
+    
+    // Level 0 holds everything due before the end of this lap exactly;
+    // anything higher is due at the lap boundary at the earliest. Sitting
+    // on a boundary means its cascade is still to run, so wake for that.
+    int start = static_cast<int>(current & (SLOTS - 1));
+    if (start == 0 && higher_levels_occupied()) {
+        return origin + std::chrono::duration_cast<std::chrono::steady_clock::duration>(tick * current);
+    }
+    
+    uint64_t earliest = (current | (SLOTS - 1)) + 1;
+    int slot = next_level0_slot();
+    if (slot >= start) {
+        earliest = current - start + slot;
+    }
+    
+    return origin + std::chrono::duration_cast<std::chrono::steady_clock::duration>(tick * earliest);
+}
@@ -0,0 +1,36 @@
+#include "multikernel.h"
+
+// ============================================================================
+// TOPIC DIRECTORY IMPLEMENTATION
+// ============================================================================
+
+int TopicDirectory::lookup(const std::string& name) {
+    std::lock_guard<std::mutex> lock(names_mutex);
+    
+    auto it = names.find(name);
+    if (it != names.end()) return it->second;
+    
+    if (static_cast<int>(names.size()) >= MAX_TOPICS) return -1;
+    int id = static_cast<int>(names.size());
+    names[name] = id;
+    return id;
+}
+
+void TopicDirectory::subscribe(int topic, int core) {
+    if (topic < 0 || topic >= MAX_TOPICS || core < 0 || core >= NUM_CORES) return;
+    subscribers[topic].fetch_or(1ULL << core);
+}
+
+void TopicDirectory::unsubscribe(int topic, int core) {
+    if (topic < 0 || topic >= MAX_TOPICS || core < 0 || core >= NUM_CORES) return;
+    subscribers[topic].fetch_and(~(1ULL << core));
+}
+
+bool TopicDirectory::is_subscribed(int topic, int core) const {
+    return (subscribers_of(topic) >> core) & 1;
+}
+
+uint64_t TopicDirectory::subscribers_of(int topic) const {
+    if (topic < 0 || topic >= MAX_TOPICS) return 0;
+    return subscribers[topic].load();
+}
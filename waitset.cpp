@@ -0,0 +1,174 @@
+#include "multikernel.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+// ============================================================================
+// WAIT SET IMPLEMENTATION
+// ============================================================================
+
+// epoll data of the wait_until timerfd; source ids count up from 0
+static const uint32_t DEADLINE_SOURCE = UINT32_MAX;
+
+WaitSet::WaitSet() {
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+}
+
+WaitSet::~WaitSet() {
+    for (const auto& entry : sources) {
+        // Mailbox and inbox eventfds belong to the PCB or core; timerfds to us
+        if (entry.second.kind == WAIT_TIMER) close(entry.second.fd);
+    }
+    if (deadline_fd >= 0) close(deadline_fd);
+    if (epoll_fd >= 0) close(epoll_fd);
+}
+
+int WaitSet::add_source(WaitSourceKind kind, int fd,
+                        std::shared_ptr<ProcessControlBlock> process, CoreKernel* core) {
+    if (epoll_fd < 0 || fd < 0) return -1;
+    
+    std::lock_guard<std::mutex> lock(sources_mutex);
+    int id = next_id++;
+    
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u32 = static_cast<uint32_t>(id);
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        return -1;
+    }
+    
+    sources[id] = {kind, fd, std::move(process), core};
+    return id;
+}
+
+int WaitSet::add_mailbox(CoreKernel* core, int pid) {
+    // Holding the PCB keeps its eventfd open for as long as we watch it
+    auto pcb = core->watch_mailbox(pid);
+    if (!pcb) return -1;
+    return add_source(WAIT_MAIL, pcb->mail_fd, pcb);
+}
+
+int WaitSet::add_inbox(CoreKernel* core) {
+    // Anyone else would race the worker for the same messages
+    int fd = core->watch_inbox();
+    if (fd < 0) return -1;
+    return add_source(WAIT_INBOX, fd, nullptr, core);
+}
+
+int WaitSet::add_timer(std::chrono::microseconds interval, bool periodic) {
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd < 0) return -1;
+    
+    // A zero it_value would disarm the timer, so round up to 1 ns
+    long long ns = std::max<long long>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(interval).count(), 1);
+    itimerspec spec{};
+    spec.it_value.tv_sec = ns / 1000000000;
+    spec.it_value.tv_nsec = ns % 1000000000;
+    if (periodic) spec.it_interval = spec.it_value;
+    
+    int id = -1;
+    if (timerfd_settime(fd, 0, &spec, nullptr) == 0) {
+        id = add_source(WAIT_TIMER, fd, nullptr);
+    }
+    if (id < 0) close(fd);
+    return id;
+}
+
+int WaitSet::add_fd(int fd) {
+    return add_source(WAIT_FD, fd, nullptr);
+}
+
+bool WaitSet::remove(int id) {
+    std::lock_guard<std::mutex> lock(sources_mutex);
+    auto it = sources.find(id);
+    if (it == sources.end()) return false;
+    
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+    if (it->second.kind == WAIT_TIMER) close(it->second.fd);
+    sources.erase(it);
+    return true;
+}
+
+int WaitSet::wait(std::vector<WaitEvent>& ready, int timeout_ms) {
+    return collect(ready, timeout_ms);
+}
+
+int WaitSet::wait_until(std::vector<WaitEvent>& ready,
+                        std::chrono::steady_clock::time_point deadline) {
+    if (deadline == std::chrono::steady_clock::time_point::max()) return collect(ready, -1);
+    
+    // epoll_wait only counts milliseconds, which would make a worker's timers
+    // late by up to one, so a one-shot timerfd ends the wait instead
+    if (deadline_fd < 0) {
+        int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (fd < 0) return -1;
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u32 = DEADLINE_SOURCE;
+        if (epoll_fd < 0 || epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            close(fd);
+            return -1;
+        }
+        deadline_fd = fd;
+    }
+    
+    // steady_clock is CLOCK_MONOTONIC; re-arming also clears a stale expiry.
+    // A deadline already past fires at once; zero would disarm, so use 1 ns.
+    long long ns = std::max<long long>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count(), 1);
+    itimerspec spec{};
+    spec.it_value.tv_sec = ns / 1000000000;
+    spec.it_value.tv_nsec = ns % 1000000000;
+    if (timerfd_settime(deadline_fd, TFD_TIMER_ABSTIME, &spec, nullptr) < 0) return -1;
+    
+    return collect(ready, -1);
+}
+
+int WaitSet::collect(std::vector<WaitEvent>& ready, int timeout_ms) {
+    ready.clear();
+    if (epoll_fd < 0) return -1;
+    
+    // Mailboxes and inboxes only signal the first arrival after being armed,
+    // so re-arm every pass. Arming also fires at once if work is waiting.
+    {
+        std::lock_guard<std::mutex> lock(sources_mutex);
+        for (const auto& entry : sources) {
+            if (entry.second.kind == WAIT_MAIL) CoreKernel::arm_mailbox(*entry.second.process);
+            if (entry.second.kind == WAIT_INBOX) entry.second.core->arm_inbox();
+        }
+    }
+    
+    epoll_event events[64];
+    int n;
+    do {
+        n = epoll_wait(epoll_fd, events, 64, timeout_ms);
+    } while (n < 0 && errno == EINTR);
+    if (n <= 0) return n;
+    
+    std::lock_guard<std::mutex> lock(sources_mutex);
+    for (int i = 0; i < n; i++) {
+        if (events[i].data.u32 == DEADLINE_SOURCE) {
+            // Only ends the wait; consumed so a later wait() is not woken by it
+            uint64_t expirations;
+            if (read(deadline_fd, &expirations, sizeof(expirations)) < 0) {}
+            continue;
+        }
+        
+        int id = static_cast<int>(events[i].data.u32);
+        auto it = sources.find(id);
+        if (it == sources.end()) continue;     // Removed while we waited
+        
+        WaitEvent event{id, it->second.kind, 1};
+        if (it->second.kind == WAIT_TIMER) {
+            uint64_t expirations = 0;
+            if (read(it->second.fd, &expirations, sizeof(expirations)) <= 0) continue;
+            event.count = expirations;
+        }
+        ready.push_back(event);
+    }
+    return static_cast<int>(ready.size());
+}